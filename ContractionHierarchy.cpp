@@ -0,0 +1,448 @@
+#include "ContractionHierarchy.h"
+#include "Graph.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <queue>
+
+ContractionHierarchy::ContractionHierarchy() : vertexCount(0), graphEdgeCount(0), graphEdgeChecksum(0), directed(false), meeting(-1) {
+}
+
+void ContractionHierarchy::build(const Graph& graph, int witnessLimit) {
+
+    vertexCount = graph.getVertexCount();
+    graphEdgeCount = graph.getEdgeCount();
+    graphEdgeChecksum = graph.getEdgeChecksum();
+    directed = graph.isDirectedGraph();
+
+    // Step 1: Copy the graph into a mutable overlay, keeping the lightest of parallel edges
+    std::vector<std::vector<Arc>> outArcs(vertexCount);
+    std::vector<std::vector<Arc>> inArcs(vertexCount);
+
+    auto addArc = [&](int u, int w, float weight, int middle) {
+        for (Arc& arc : outArcs[u]) {
+            if (arc.to != w) continue;
+            if (weight < arc.weight) {
+                arc.weight = weight;
+                arc.middle = middle;
+                for (Arc& back : inArcs[w]) {
+                    if (back.to == u) {
+                        back.weight = weight;
+                        back.middle = middle;
+                    }
+                }
+            }
+            return;
+        }
+        outArcs[u].push_back({w, weight, middle});
+        inArcs[w].push_back({u, weight, middle});
+    };
+
+    for (int u = 0; u < vertexCount; u++) {
+        graph.forEachNeighbor(u, [&](int v, float weight) {
+            if (v != u) addArc(u, v, weight, -1);
+        });
+    }
+
+    std::vector<bool> contracted(vertexCount, false);
+    std::vector<int> deletedNeighbors(vertexCount, 0);
+    SearchContext witness;
+
+    // Bounded Dijkstra over the remaining graph that avoids skip
+    auto witnessSearch = [&](int source, int skip, float maxCost) {
+        witness.begin(vertexCount);
+        witness.relax(source, 0, 0, -1);
+        int settled = 0;
+
+        while (!witness.empty()) {
+            auto entry = witness.pop();
+            if (witness.isStale(entry)) continue;
+            if (entry.first > maxCost || ++settled > witnessLimit) break;
+
+            int current = entry.second;
+            for (const Arc& arc : outArcs[current]) {
+                if (contracted[arc.to] || arc.to == skip) continue;
+                float distance = entry.first + arc.weight;
+                if (distance < witness.getDistance(arc.to)) {
+                    witness.relax(arc.to, distance, distance, current);
+                }
+            }
+        }
+    };
+
+    // Count, and optionally add, the shortcuts needed to remove v
+    auto contract = [&](int v, bool apply) {
+        int shortcuts = 0;
+        for (size_t i = 0; i < inArcs[v].size(); i++) {
+            Arc in = inArcs[v][i];
+            if (contracted[in.to]) continue;
+
+            float maxCost = -1;
+            for (const Arc& out : outArcs[v]) {
+                if (!contracted[out.to] && out.to != in.to) maxCost = std::max(maxCost, in.weight + out.weight);
+            }
+            if (maxCost < 0) continue;
+
+            witnessSearch(in.to, v, maxCost);
+
+            for (size_t j = 0; j < outArcs[v].size(); j++) {
+                Arc out = outArcs[v][j];
+                if (contracted[out.to] || out.to == in.to) continue;
+
+                float via = in.weight + out.weight;
+                if (witness.getDistance(out.to) <= via) continue;
+
+                shortcuts++;
+                if (apply) addArc(in.to, out.to, via, v);
+            }
+        }
+        return shortcuts;
+    };
+
+    // Edge difference plus a term that spreads contraction evenly over the graph
+    auto priority = [&](int v) {
+        int removed = 0;
+        for (const Arc& arc : inArcs[v]) if (!contracted[arc.to]) removed++;
+        for (const Arc& arc : outArcs[v]) if (!contracted[arc.to]) removed++;
+        return contract(v, false) - removed + deletedNeighbors[v];
+    };
+
+    // Step 2: Contract vertices in lazily updated priority order
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> order;
+    for (int v = 0; v < vertexCount; v++) {
+        order.emplace(priority(v), v);
+    }
+
+    rank.assign(vertexCount, 0);
+    int nextRank = 0;
+    while (!order.empty()) {
+        auto [oldPriority, v] = order.top();
+        order.pop();
+        if (contracted[v]) continue;
+
+        int newPriority = priority(v);
+        if (!order.empty() && newPriority > order.top().first) {
+            order.emplace(newPriority, v);
+            continue;
+        }
+
+        contract(v, true);
+        contracted[v] = true;
+        rank[v] = nextRank++;
+
+        for (const Arc& arc : inArcs[v]) deletedNeighbors[arc.to]++;
+        for (const Arc& arc : outArcs[v]) deletedNeighbors[arc.to]++;
+    }
+
+    // Step 3: Every overlay arc, original or shortcut, is part of the hierarchy
+    edgeFrom.clear();
+    edgeTo.clear();
+    edgeWeight.clear();
+    edgeMiddle.clear();
+    for (int u = 0; u < vertexCount; u++) {
+        for (const Arc& arc : outArcs[u]) {
+            edgeFrom.push_back(u);
+            edgeTo.push_back(arc.to);
+            edgeWeight.push_back(arc.weight);
+            edgeMiddle.push_back(arc.middle);
+        }
+    }
+
+    buildQueryGraph();
+}
+
+void ContractionHierarchy::buildQueryGraph() {
+
+    upOffsets.assign(vertexCount + 1, 0);
+    downOffsets.assign(vertexCount + 1, 0);
+    shortcutMiddle.clear();
+
+    // Edges climbing in rank are searched forward; the rest are searched backward from their head
+    for (size_t i = 0; i < edgeFrom.size(); i++) {
+        if (rank[edgeFrom[i]] < rank[edgeTo[i]]) upOffsets[edgeFrom[i] + 1]++;
+        else downOffsets[edgeTo[i] + 1]++;
+
+        if (edgeMiddle[i] != -1) shortcutMiddle[edgeKey(edgeFrom[i], edgeTo[i])] = edgeMiddle[i];
+    }
+    for (int v = 0; v < vertexCount; v++) {
+        upOffsets[v + 1] += upOffsets[v];
+        downOffsets[v + 1] += downOffsets[v];
+    }
+
+    upTargets.resize(upOffsets[vertexCount]);
+    upWeights.resize(upOffsets[vertexCount]);
+    downTargets.resize(downOffsets[vertexCount]);
+    downWeights.resize(downOffsets[vertexCount]);
+
+    std::vector<int> upCursor(upOffsets.begin(), upOffsets.end() - 1);
+    std::vector<int> downCursor(downOffsets.begin(), downOffsets.end() - 1);
+    for (size_t i = 0; i < edgeFrom.size(); i++) {
+        int u = edgeFrom[i];
+        int w = edgeTo[i];
+        if (rank[u] < rank[w]) {
+            upTargets[upCursor[u]] = w;
+            upWeights[upCursor[u]++] = edgeWeight[i];
+        }
+        else {
+            downTargets[downCursor[w]] = u;
+            downWeights[downCursor[w]++] = edgeWeight[i];
+        }
+    }
+}
+
+float ContractionHierarchy::search(int start, int goal) {
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    float best = infinity;
+    meeting = -1;
+
+    forward.begin(vertexCount);
+    backward.begin(vertexCount);
+    forward.relax(start, 0, 0, -1);
+    backward.relax(goal, 0, 0, -1);
+
+    // Settle one vertex from a direction; returns false once that direction can no longer improve best
+    auto step = [&](SearchContext& self, const SearchContext& other, const std::vector<int>& offsets,
+                    const std::vector<int>& targets, const std::vector<float>& weights) {
+        while (!self.empty()) {
+            auto entry = self.pop();
+            if (self.isStale(entry)) continue;
+            if (entry.first >= best) return false;
+
+            int current = entry.second;
+            float total = entry.first + other.getDistance(current);
+            if (total < best) {
+                best = total;
+                meeting = current;
+            }
+
+            for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+                float distance = entry.first + weights[e];
+                if (distance < self.getDistance(targets[e])) {
+                    self.relax(targets[e], distance, distance, current);
+                }
+            }
+            return true;
+        }
+        return false;
+    };
+
+    bool forwardActive = true;
+    bool backwardActive = true;
+    while (forwardActive || backwardActive) {
+        if (forwardActive) forwardActive = step(forward, backward, upOffsets, upTargets, upWeights);
+        if (backwardActive) backwardActive = step(backward, forward, downOffsets, downTargets, downWeights);
+    }
+
+    return best;
+}
+
+void ContractionHierarchy::unpackEdge(int from, int to, std::vector<int>& path) const {
+    auto it = shortcutMiddle.find(edgeKey(from, to));
+    if (it == shortcutMiddle.end()) {
+        path.push_back(to);
+        return;
+    }
+    unpackEdge(from, it->second, path);
+    unpackEdge(it->second, to, path);
+}
+
+float ContractionHierarchy::distance(int start, int goal) {
+    // query() and findPath() read meeting next, so it must not be left over from the last query
+    if (start < 0 || start >= vertexCount || goal < 0 || goal >= vertexCount) {
+        meeting = -1;
+        return std::numeric_limits<float>::infinity();
+    }
+    return search(start, goal);
+}
+
+int ContractionHierarchy::firstStep(int start, int goal) {
+    float ignored;
+    return query(start, goal, ignored);
+}
+
+int ContractionHierarchy::query(int start, int goal, float& routeDistance) {
+
+    routeDistance = distance(start, goal);
+    if (meeting == -1 || start == goal) return -1;
+
+    // The first hierarchy edge either climbs towards the meeting vertex or, if the start
+    // is the meeting vertex, descends towards the goal
+    int next;
+    if (meeting != start) {
+        next = meeting;
+        while (forward.getPrevious(next) != start) {
+            next = forward.getPrevious(next);
+        }
+    }
+    else {
+        next = backward.getPrevious(start);
+    }
+
+    // The first original edge is the first half of the shortcut, repeatedly
+    auto it = shortcutMiddle.find(edgeKey(start, next));
+    while (it != shortcutMiddle.end()) {
+        next = it->second;
+        it = shortcutMiddle.find(edgeKey(start, next));
+    }
+    return next;
+}
+
+bool ContractionHierarchy::findPath(int start, int goal, std::vector<int>& path) {
+
+    path.clear();
+    distance(start, goal);
+    if (meeting == -1) return false;
+
+    // Hierarchy vertices: start up to the meeting vertex, then down to the goal
+    std::vector<int> route;
+    for (int current = meeting; current != -1; current = forward.getPrevious(current)) {
+        route.push_back(current);
+    }
+    std::reverse(route.begin(), route.end());
+    for (int current = backward.getPrevious(meeting); current != -1; current = backward.getPrevious(current)) {
+        route.push_back(current);
+    }
+
+    path.push_back(start);
+    for (size_t i = 0; i + 1 < route.size(); i++) {
+        unpackEdge(route[i], route[i + 1], path);
+    }
+    return true;
+}
+
+bool ContractionHierarchy::prepare(const Graph& graph, const std::string& path) {
+    if (load(path, graph)) {
+        return true;
+    }
+    build(graph);
+    return save(path);
+}
+
+bool ContractionHierarchy::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(9);
+    file << "ch," << vertexCount << "," << graphEdgeCount << "," << edgeFrom.size() << "," << (directed ? 1 : 0) << "," << graphEdgeChecksum << "\n";
+
+    file << "rank";
+    for (int v = 0; v < vertexCount; v++) {
+        file << "," << rank[v];
+    }
+    file << "\n";
+
+    for (size_t i = 0; i < edgeFrom.size(); i++) {
+        file << "edge," << edgeFrom[i] << "," << edgeTo[i] << "," << edgeWeight[i] << "," << edgeMiddle[i] << "\n";
+    }
+
+    file.close();
+    return true;
+}
+
+bool ContractionHierarchy::load(const std::string& path, const Graph& graph) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    auto reject = [&]() {
+        vertexCount = 0;
+        rank.clear();
+        edgeFrom.clear();
+        edgeTo.clear();
+        edgeWeight.clear();
+        edgeMiddle.clear();
+        return false;
+    };
+    reject();
+
+    bool headerRead = false;
+    size_t expectedEdges = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<std::string> row;
+        while (std::getline(ss, cell, ',')) {
+            row.push_back(cell);
+        }
+        if (row.empty()) continue;
+
+        try {
+            if (row[0] == "ch") {
+                // Files saved before the direction and checksum were added cannot be checked, so they are rebuilt
+                if (row.size() < 6) return reject();
+
+                vertexCount = std::stoi(row[1]);
+                graphEdgeCount = std::stol(row[2]);
+                expectedEdges = std::stoul(row[3]);
+                directed = std::stoi(row[4]) != 0;
+                graphEdgeChecksum = std::stoull(row[5]);
+
+                // A hierarchy of a different or reweighted graph gives wrong distances, not just slow ones
+                if (vertexCount != graph.getVertexCount() || graphEdgeCount != graph.getEdgeCount()
+                    || directed != graph.isDirectedGraph() || graphEdgeChecksum != graph.getEdgeChecksum()) {
+                    return reject();
+                }
+                headerRead = true;
+            }
+            else if (row[0] == "rank") {
+                for (size_t i = 1; i < row.size(); i++) {
+                    rank.push_back(std::stoi(row[i]));
+                }
+            }
+            else if (row[0] == "edge" && row.size() >= 5) {
+                edgeFrom.push_back(std::stoi(row[1]));
+                edgeTo.push_back(std::stoi(row[2]));
+                edgeWeight.push_back(std::stof(row[3]));
+                edgeMiddle.push_back(std::stoi(row[4]));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Conversion Error: " << e.what() << " in " << path << std::endl;
+            return reject();
+        }
+    }
+
+    file.close();
+
+    if (!headerRead || (int) rank.size() != vertexCount || edgeFrom.size() != expectedEdges || vertexCount == 0) {
+        return reject();
+    }
+
+    // buildQueryGraph indexes arrays with every rank and endpoint, so a truncated or edited
+    // file must not get that far. The ranks have to be a permutation of the vertices
+    std::vector<char> rankSeen(vertexCount, 0);
+    for (int r : rank) {
+        if (r < 0 || r >= vertexCount || rankSeen[r]) return reject();
+        rankSeen[r] = 1;
+    }
+    for (size_t i = 0; i < edgeFrom.size(); i++) {
+        if (edgeFrom[i] < 0 || edgeFrom[i] >= vertexCount || edgeTo[i] < 0 || edgeTo[i] >= vertexCount) return reject();
+        if (edgeMiddle[i] < -1 || edgeMiddle[i] >= vertexCount) return reject();
+
+        // Every middle was contracted before both ends of its shortcut. Unpacking then only ever
+        // moves to lower ranks, so an edited file cannot make unpackEdge or query() loop
+        if (edgeMiddle[i] != -1 && (rank[edgeMiddle[i]] >= rank[edgeFrom[i]] || rank[edgeMiddle[i]] >= rank[edgeTo[i]])) {
+            return reject();
+        }
+    }
+
+    buildQueryGraph();
+    return true;
+}
+
+int ContractionHierarchy::getShortcutCount() const {
+    int count = 0;
+    for (int middle : edgeMiddle) {
+        if (middle != -1) count++;
+    }
+    return count;
+}
+
+bool ContractionHierarchy::empty() const {
+    return vertexCount == 0;
+}
@@ -0,0 +1,138 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SearchContext.h"
+
+class Graph;
+
+/**
+ * Contraction hierarchy over a static Graph.
+ *
+ * Preprocessing contracts vertices one at a time in order of importance, adding shortcut
+ * edges wherever removing a vertex would lengthen a shortest path. A query then runs two
+ * small Dijkstras that only climb to higher-ranked vertices and meet in the middle.
+ *
+ * The hierarchy is a snapshot: rebuild it if the graph changes.
+ */
+class ContractionHierarchy {
+private:
+    /** An edge during preprocessing. middle is the contracted vertex a shortcut skips, -1 for original edges */
+    struct Arc {
+        int to;
+        float weight;
+        int middle;
+    };
+
+    /** Number of vertices */
+    int vertexCount;
+    /** Adjacency entries of the graph the hierarchy was built from, used to reject stale files */
+    long graphEdgeCount;
+    /** Graph::getEdgeChecksum and direction of that graph, so reweighted edges are rejected too */
+    std::uint64_t graphEdgeChecksum;
+    bool directed;
+    /** Contraction order of every vertex, higher is more important */
+    std::vector<int> rank;
+    /** Every final edge (u, v, weight, middle), original and shortcut */
+    std::vector<int> edgeFrom;
+    std::vector<int> edgeTo;
+    std::vector<float> edgeWeight;
+    std::vector<int> edgeMiddle;
+
+    /** Upward CSR graph searched forward from the start */
+    std::vector<int> upOffsets;
+    std::vector<int> upTargets;
+    std::vector<float> upWeights;
+    /** Upward CSR graph of reversed edges searched backward from the goal */
+    std::vector<int> downOffsets;
+    std::vector<int> downTargets;
+    std::vector<float> downWeights;
+    /** Skipped vertex of every shortcut, keyed by (from, to) */
+    std::unordered_map<std::uint64_t, int> shortcutMiddle;
+
+    /** Query scratch space */
+    SearchContext forward;
+    SearchContext backward;
+    /** Vertex where the last query's searches met, -1 if unreachable */
+    int meeting;
+
+    static std::uint64_t edgeKey(int from, int to) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(from)) << 32) | static_cast<std::uint32_t>(to);
+    }
+
+    /**
+     * Build the upward query graphs and the shortcut lookup from the final edge list
+     */
+    void buildQueryGraph();
+
+    /**
+     * Run the bidirectional upward search, leaving the meeting vertex in meeting
+     */
+    float search(int start, int goal);
+
+    /**
+     * Append the original vertices an edge expands to, excluding from
+     */
+    void unpackEdge(int from, int to, std::vector<int>& path) const;
+
+public:
+
+    ContractionHierarchy();
+
+    /**
+     * Contract every vertex of the graph
+     *
+     * @param graph The static graph to preprocess
+     * @param witnessLimit Vertices a witness search may settle before a shortcut is added anyway
+     */
+    void build(const Graph& graph, int witnessLimit = 64);
+
+    /**
+     * Load a hierarchy saved next to the graph files, or build and save one if missing or stale
+     */
+    bool prepare(const Graph& graph, const std::string& path);
+
+    /**
+     * Write the ranks and final edges as csv
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * Read a hierarchy written by save, rejecting it if it was built from a different or reweighted
+     * graph, or if its ranks or edges do not fit the graph
+     */
+    bool load(const std::string& path, const Graph& graph);
+
+    /**
+     * Get the shortest distance from start to goal, infinity if unreachable
+     */
+    float distance(int start, int goal);
+
+    /**
+     * Get the first step from start towards goal, -1 if unreachable. Same contract as Graph::astar
+     */
+    int firstStep(int start, int goal);
+
+    /**
+     * Get the first step and distance of a route in one query
+     *
+     * @return the first step, -1 if unreachable
+     */
+    int query(int start, int goal, float& distance);
+
+    /**
+     * Fill path with every original vertex from start to goal
+     *
+     * @return if the goal is reachable
+     */
+    bool findPath(int start, int goal, std::vector<int>& path);
+
+    int getShortcutCount() const;
+
+    bool empty() const;
+};
+
+#endif
@@ -0,0 +1,265 @@
+#include "DStarLite.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+DStarLite::DStarLite(Graph& graph, int start, int goal)
+: graph(graph), listenerId(-1), remapListenerId(-1), start(start), goal(goal), lastStart(start), km(0), expansions(0) {
+
+    reset();
+
+    listenerId = graph.addEdgeListener([this](int u, int v) { edgeChanged(u, v); });
+    remapListenerId = graph.addRemapListener([this](const std::vector<int>& newIds) { verticesRemapped(newIds); });
+}
+
+DStarLite::~DStarLite() {
+    graph.removeEdgeListener(listenerId);
+    graph.removeRemapListener(remapListenerId);
+}
+
+void DStarLite::reset() {
+    g.clear();
+    rhs.clear();
+    queuedKey.clear();
+    queued.clear();
+    predecessors.clear();
+    open = {};
+    lastStart = start;
+    km = 0;
+
+    reserve(graph.getVertexCount());
+
+    // A directed graph can only be walked forward, so record who points at whom
+    if (graph.isDirectedGraph()) {
+        for (int u = 0; u < graph.getVertexCount(); u++) {
+            graph.forEachNeighbor(u, [&](int v, float) {
+                predecessors[v].push_back(u);
+            });
+        }
+    }
+
+    if (goal < 0 || goal >= (int) g.size()) return;
+
+    rhs[goal] = 0;
+    updateVertex(goal);
+}
+
+void DStarLite::verticesRemapped(const std::vector<int>& newIds) {
+    auto remap = [&](int v) {
+        return v >= 0 && v < (int) newIds.size() ? newIds[v] : -1;
+    };
+
+    // A removed start or goal becomes -1, and plan() reports the goal unreachable
+    start = remap(start);
+    goal = remap(goal);
+    reset();
+}
+
+void DStarLite::reserve(int vertexCount) {
+    if (vertexCount <= (int) g.size()) return;
+
+    g.resize(vertexCount, INF);
+    rhs.resize(vertexCount, INF);
+    queuedKey.resize(vertexCount);
+    queued.resize(vertexCount, false);
+    if (graph.isDirectedGraph()) predecessors.resize(vertexCount);
+}
+
+float DStarLite::heuristic(int u, int v) const {
+    int count = graph.getVertexCount();
+    if (u < 0 || u >= count || v < 0 || v >= count) return 0;
+
+    sf::Vector2f d = graph.getPosition(u) - graph.getPosition(v);
+    return std::sqrt(d.x * d.x + d.y * d.y);
+}
+
+DStarLite::Key DStarLite::calculateKey(int v) const {
+    float best = std::min(g[v], rhs[v]);
+    return {best + heuristic(start, v) + km, best};
+}
+
+float DStarLite::cost(int u, int v) const {
+    float weight = INF;
+    graph.forEachNeighbor(u, [&](int neighbor, float w) {
+        if (neighbor == v) weight = std::min(weight, w);
+    });
+    return weight;
+}
+
+float DStarLite::lookahead(int u) const {
+    float best = INF;
+    graph.forEachNeighbor(u, [&](int v, float weight) {
+        if (v >= 0 && v < (int) g.size()) best = std::min(best, weight + g[v]);
+    });
+    return best;
+}
+
+void DStarLite::updateVertex(int u) {
+    if (g[u] != rhs[u]) {
+        queuedKey[u] = calculateKey(u);
+        queued[u] = true;
+        open.push({queuedKey[u], u});
+    }
+    else {
+        queued[u] = false;
+    }
+}
+
+template <typename Visitor>
+void DStarLite::forEachPredecessor(int v, Visitor&& visit) const {
+    if (graph.isDirectedGraph()) {
+        for (int u : predecessors[v]) {
+            visit(u);
+        }
+        return;
+    }
+
+    // Undirected edges are stored in both directions, so neighbors are predecessors
+    graph.forEachNeighbor(v, [&](int u, float) {
+        visit(u);
+    });
+}
+
+void DStarLite::edgeChanged(int u, int v) {
+    reserve(graph.getVertexCount());
+    if (u < 0 || u >= (int) g.size() || v < 0 || v >= (int) g.size()) return;
+
+    if (graph.isDirectedGraph() && cost(u, v) < INF &&
+        std::find(predecessors[v].begin(), predecessors[v].end(), u) == predecessors[v].end()) {
+        predecessors[v].push_back(u);
+    }
+
+    // Only u's lookahead can change; plan() propagates the rest
+    if (u != goal) {
+        rhs[u] = lookahead(u);
+        updateVertex(u);
+    }
+}
+
+bool DStarLite::plan() {
+    reserve(graph.getVertexCount());
+    if (start < 0 || start >= (int) g.size() || goal < 0 || goal >= (int) g.size()) return false;
+
+    while (!open.empty()) {
+        auto [key, u] = open.top();
+
+        // Skip entries that were re-queued with another key or are consistent again
+        if (!queued[u] || key != queuedKey[u]) {
+            open.pop();
+            continue;
+        }
+
+        if (!(key < calculateKey(start)) && rhs[start] == g[start]) break;
+
+        open.pop();
+        queued[u] = false;
+
+        // The agent moved since u was queued, so its key only got larger
+        Key newKey = calculateKey(u);
+        if (key < newKey) {
+            updateVertex(u);
+            continue;
+        }
+
+        expansions++;
+
+        if (g[u] > rhs[u]) {
+            // Overconsistent: settle u and offer it to its predecessors
+            g[u] = rhs[u];
+            forEachPredecessor(u, [&](int p) {
+                if (p == goal) return;
+                float through = cost(p, u) + g[u];
+                if (through < rhs[p]) {
+                    rhs[p] = through;
+                    updateVertex(p);
+                }
+            });
+        }
+        else {
+            // Underconsistent: u got more expensive, so anything that relied on it must look again
+            float oldG = g[u];
+            g[u] = INF;
+
+            auto repair = [&](int p) {
+                if (p != goal && rhs[p] == cost(p, u) + oldG) {
+                    rhs[p] = lookahead(p);
+                }
+                updateVertex(p);
+            };
+            forEachPredecessor(u, repair);
+            repair(u);
+        }
+    }
+
+    return rhs[start] < INF;
+}
+
+void DStarLite::moveTo(int newStart) {
+    if (newStart == start) return;
+
+    start = newStart;
+    km += heuristic(lastStart, start);
+    lastStart = start;
+}
+
+int DStarLite::nextStep() const {
+    if (start < 0 || start >= (int) g.size() || start == goal || rhs[start] == INF) return -1;
+
+    int best = -1;
+    float bestCost = INF;
+    graph.forEachNeighbor(start, [&](int v, float weight) {
+        if (v >= 0 && v < (int) g.size() && weight + g[v] < bestCost) {
+            bestCost = weight + g[v];
+            best = v;
+        }
+    });
+    return best;
+}
+
+bool DStarLite::getPath(Path& path) const {
+    path.vertices.clear();
+    path.distance = 0;
+
+    if (start < 0 || start >= (int) g.size() || rhs[start] == INF) return false;
+
+    // Follow the cheapest successor; the vertex count bounds the walk if the tree is stale
+    int current = start;
+    path.vertices.push_back(current);
+    while (current != goal && (int) path.vertices.size() <= (int) g.size()) {
+        int best = -1;
+        float bestCost = INF, bestWeight = 0;
+        graph.forEachNeighbor(current, [&](int v, float weight) {
+            if (v >= 0 && v < (int) g.size() && weight + g[v] < bestCost) {
+                bestCost = weight + g[v];
+                bestWeight = weight;
+                best = v;
+            }
+        });
+        if (best == -1) break;
+
+        path.vertices.push_back(best);
+        path.distance += bestWeight;
+        current = best;
+    }
+
+    return current == goal;
+}
+
+float DStarLite::getDistance() const {
+    if (start < 0 || start >= (int) rhs.size()) return INF;
+    return rhs[start];
+}
+
+int DStarLite::getStart() const {
+    return start;
+}
+
+int DStarLite::getGoal() const {
+    return goal;
+}
+
+long DStarLite::getExpansions() const {
+    return expansions;
+}
@@ -0,0 +1,158 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+/**
+ * D* Lite incremental replanner for one agent travelling to a fixed goal.
+ *
+ * The search runs backward from the goal, so the agent can keep moving while
+ * the search tree stays rooted at the goal. The replanner subscribes to the
+ * graph's edge changes. Each change only marks the tail of the edge as
+ * inconsistent, and the next plan() call repairs the part of the tree that
+ * the change can affect instead of searching again from scratch.
+ *
+ * Keep one replanner per active agent. The graph must outlive it, and it must
+ * be rebuilt if the graph is replaced with loadBinary. Graph::compact() is
+ * followed: start and goal are renumbered and the next plan() searches afresh.
+ */
+class DStarLite {
+private:
+    /** Two part priority: (min(g, rhs) + h + km, min(g, rhs)), compared lexicographically */
+    using Key = std::pair<float, float>;
+    using Entry = std::pair<Key, int>;
+
+    Graph& graph;
+    /** Id of the edge listener registered with the graph */
+    int listenerId;
+    /** Id of the remap listener registered with the graph */
+    int remapListenerId;
+    int start;
+    int goal;
+    /** Where the agent stood when km was last updated */
+    int lastStart;
+    /** Heuristic offset accumulated as the agent moves, so queued keys stay valid */
+    float km;
+
+    /** Cost to the goal when last expanded */
+    std::vector<float> g;
+    /** One step lookahead cost to the goal */
+    std::vector<float> rhs;
+    /** Key each queued vertex was last pushed with, and if it is still queued */
+    std::vector<Key> queuedKey;
+    std::vector<bool> queued;
+    /** Min-heap of inconsistent vertices. Entries superseded by a later push are skipped when popped */
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    /** Predecessors of every vertex on directed graphs; may hold removed edges, which cost infinity */
+    std::vector<std::vector<int>> predecessors;
+
+    /** Vertices expanded since construction */
+    long expansions;
+
+    /**
+     * Grow the per-vertex arrays after vertices are added to the graph
+     */
+    void reserve(int vertexCount);
+
+    /**
+     * Drop all search state and seed the goal, as a new replanner would
+     */
+    void reset();
+
+    /**
+     * Straight-line distance between two vertices. Pinned instead of Graph::heuristic, which
+     * switches between ALT bounds and positional estimates as landmarks are built or dropped;
+     * keys already queued must stay comparable with new ones
+     */
+    float heuristic(int u, int v) const;
+
+    Key calculateKey(int v) const;
+
+    /**
+     * Cheapest edge from u to v, infinity if there is none
+     */
+    float cost(int u, int v) const;
+
+    /**
+     * Recompute rhs(u) from its successors
+     */
+    float lookahead(int u) const;
+
+    /**
+     * Queue u if it is inconsistent, or drop it from the queue if it is not
+     */
+    void updateVertex(int u);
+
+    /**
+     * Visit every vertex with an edge into v
+     */
+    template <typename Visitor>
+    void forEachPredecessor(int v, Visitor&& visit) const;
+
+    /**
+     * Mark the tail of a changed edge for repair
+     */
+    void edgeChanged(int u, int v);
+
+    /**
+     * Follow compact(): every per-vertex array is indexed by old ids, so start over on the new ones
+     */
+    void verticesRemapped(const std::vector<int>& newIds);
+
+public:
+
+    /**
+     * Subscribe to the graph and seed the search. No searching happens until plan()
+     *
+     * @param graph The graph to plan on
+     * @param start The agent's current vertex
+     * @param goal The vertex to reach
+     */
+    DStarLite(Graph& graph, int start, int goal);
+
+    ~DStarLite();
+
+    DStarLite(const DStarLite&) = delete;
+    DStarLite& operator=(const DStarLite&) = delete;
+
+    /**
+     * Repair the search tree after edge changes and moves. The first call is a full search
+     *
+     * @return if the goal is reachable from the current start
+     */
+    bool plan();
+
+    /**
+     * Tell the replanner the agent moved. Call plan() before reading the route again
+     */
+    void moveTo(int newStart);
+
+    /**
+     * Get the best move out of the current start, -1 if the goal is unreachable or already reached
+     */
+    int nextStep() const;
+
+    /**
+     * Fill path with the route from the current start to the goal as of the last plan()
+     *
+     * @return if the goal is reachable
+     */
+    bool getPath(Path& path) const;
+
+    /**
+     * Cost from the current start to the goal as of the last plan(), infinity if unreachable
+     */
+    float getDistance() const;
+
+    int getStart() const;
+
+    int getGoal() const;
+
+    long getExpansions() const;
+};
+
+#endif
@@ -1,9 +1,11 @@
 #include "Entity.h"
 #include "SteeringBehavior.h"
 
-Entity::Entity(const int id, const std::string& textureFile, const sf::Vector2f& startPos) {
+Entity::Entity(const int id, const std::string& textureFile, const sf::Vector2f& startPos, KinematicStore& kinematics)
+: kinematics(kinematics), breadcrumb(nullptr) {
 
-    if (!texture.loadFromFile(textureFile)) {
+    // No texture file means a headless run; the sprite is never drawn
+    if (!textureFile.empty() && !texture.loadFromFile(textureFile)) {
         throw std::runtime_error("Failed to load text: " + textureFile);
     }
     
@@ -11,6 +13,7 @@ Entity::Entity(const int id, const std::string& textureFile, const sf::Vector2f&
     sprite.setOrigin(5, 3.5);
 
     // Initialize basic stats
+    Kinematic kinematic;
     kinematic.id = id;
 
     kinematic.position = startPos;
@@ -23,6 +26,7 @@ Entity::Entity(const int id, const std::string& textureFile, const sf::Vector2f&
     kinematic.maxRotation = M_PI / 4;
 
     sprite.setPosition(kinematic.position);
+    slot = kinematics.add(kinematic, KinematicStore::ENTITY);
 
     thirst = 60.0;
     
@@ -63,6 +67,7 @@ Entity::Entity(const int id, const std::string& textureFile, const sf::Vector2f&
 
 Entity::~Entity() {
     delete breadcrumb;
+    kinematics.remove(slot);
 }
 
 void Entity::update(float deltaTime) {
@@ -82,6 +87,7 @@ void Entity::update(float deltaTime) {
 
     
 
+    Kinematic kinematic = getKinematic();
     targetKinematic = kinematic;
 
     if (breadcrumb != nullptr) {
@@ -97,65 +103,49 @@ void Entity::update(float deltaTime) {
         total.angular += output.angular;
     }
 
-    kinematic.position += kinematic.velocity * deltaTime;
-    kinematic.orientation += kinematic.rotation * deltaTime;;
-
-    kinematic.velocity += total.linear * deltaTime;
-    kinematic.rotation += total.angular * deltaTime;
-
-    // Max velocity if it tires to go over
-    if (VectorUtils::vector2Length(kinematic.velocity) > kinematic.maxSpeed) {
-        kinematic.velocity = VectorUtils::normalize(kinematic.velocity) * kinematic.maxSpeed;
-    }
-
-    // Max rotation if it tries to go over
-    if (std::fabs(kinematic.rotation) > kinematic.maxRotation) {
-        kinematic.rotation = (int) std::copysign(1.0f, kinematic.rotation) * kinematic.maxRotation;
-    }
-
-    setPosition(kinematic.position);
-    setOrientation(kinematic.orientation);
-    setKinematic(kinematic);
+    // Game integrates every agent at once through the KinematicStore
+    kinematics.setSteering(slot, total);
 
     thirst -= deltaTime;
 }
 
-void Entity::render(sf::RenderWindow& window) {
+void Entity::render(sf::RenderWindow& window, float alpha) {
     if (breadcrumb != nullptr) {
         breadcrumb->render(window);
     }
+    sprite.setPosition(VectorUtils::lerp(kinematics.getPreviousPosition(slot), kinematics.getPosition(slot), alpha));
+    sprite.setRotation(VectorUtils::radiansToDegrees(VectorUtils::lerpOrientation(kinematics.getPreviousOrientation(slot), kinematics.getOrientation(slot), alpha)));
     window.draw(sprite);
 } 
 
 void Entity::setPosition(const sf::Vector2f &newPosition) {
-    kinematic.position = newPosition;
-    sprite.setPosition(kinematic.position);
+    kinematics.setPosition(slot, newPosition);
+    sprite.setPosition(newPosition);
 }
 
 
 void Entity::setVelocity(const sf::Vector2f &newVelocity) {
-    kinematic.velocity = newVelocity;
+    kinematics.setVelocity(slot, newVelocity);
 }
 
 
 void Entity::setOrientation(const float newOrientation) {
-    kinematic.orientation = newOrientation;
-    // Ensure the angle is in the range 0 to 2p
-    kinematic.orientation = VectorUtils::mapToPiRange(kinematic.orientation);
+    // Ensure the angle is in the range -PI to PI
+    kinematics.setOrientation(slot, newOrientation);
 
     // Set rotation of sprite in degrees
-    float rot_degrees = VectorUtils::radiansToDegrees(kinematic.orientation);
+    float rot_degrees = VectorUtils::radiansToDegrees(kinematics.getOrientation(slot));
     sprite.setRotation(rot_degrees);
 }
 
 
 void Entity::setRotation(const float newRotation) {
-    kinematic.rotation = newRotation;
+    kinematics.setRotation(slot, newRotation);
 }
 
 
 void Entity::setKinematic(Kinematic &kin) {
-    kinematic = kin;
+    kinematics.set(slot, kin);
 }
 
 void Entity::setTargetKinematic(Kinematic &kin) {
@@ -163,7 +153,11 @@ void Entity::setTargetKinematic(Kinematic &kin) {
 }
 
 Kinematic Entity::getKinematic() {
-    return kinematic;
+    return kinematics.get(slot);
+}
+
+int Entity::getSlot() const {
+    return slot;
 }
 
 void Entity::addSteeringBehavior(std::unique_ptr<SteeringBehavior> behavior) {
@@ -198,7 +192,7 @@ bool Entity::hasBreadcrumb() {
 
 bool Entity::isTargetReached() {
     if (breadcrumb != nullptr) {
-        return breadcrumb->isTargetReached(kinematic.position);
+        return breadcrumb->isTargetReached(kinematics.getPosition(slot));
     }
     return false;
 }
@@ -208,7 +202,7 @@ float Entity::getThirst() {
 }
 
 bool Entity::isNearWall() {
-    sf::Vector2f pos = kinematic.position;
+    sf::Vector2f pos = kinematics.getPosition(slot);
 
     if (breadcrumb != nullptr) {
         return false;
@@ -237,7 +231,7 @@ void Entity::pathToCenter() {
 void Entity::pathToWater() {
     clearSteeringBehaviors();
     removeBreadcrumb();
-    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position);
+    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot));
     setBreadcrumb(new Breadcrumb(water->getPosition(), 10));
     addSteeringBehavior(std::make_unique<Arrive>(15, 0.1, 10, 30));
     addSteeringBehavior(std::make_unique<Align>(M_PI / 6, 0.1, M_PI / 32, M_PI / 8));
@@ -7,6 +7,7 @@
 #include "Breadcrumb.h"
 #include "DecisionTreeNode.h"
 #include "Kinematic.h"
+#include "KinematicStore.h"
 #include "VectorUtils.h"
 #include "SteeringOutput.h"
 #include <iostream>
@@ -20,8 +21,10 @@ private:
     sf::Sprite sprite;
     /** The texture of the entity */
     sf::Texture texture;
-    /** The entity's Kinematic */
-    Kinematic kinematic;
+    /** Where the kinematics of every agent live */
+    KinematicStore& kinematics;
+    /** This agent's slot in kinematics */
+    int slot;
     /** The Steering Behaviors the Entity will follow */
     std::vector<std::unique_ptr<SteeringBehavior>> behaviors;
     /** The list of breadcrumbs the Entity will try and chase */
@@ -48,10 +51,11 @@ public:
      * The entity constructor that creates a generic entity
      * 
      * @oaram id The id of the Entity
-     * @param textureFile The texture the entity will store
+     * @param textureFile The texture the entity will store, empty to load none
      * @param startPos The initial position of the entity
+     * @param kinematics The store to keep the entity's kinematic in
      */
-    Entity(const int id, const std::string& textureFile, const sf::Vector2f& startPos);
+    Entity(const int id, const std::string& textureFile, const sf::Vector2f& startPos, KinematicStore& kinematics);
 
     /**
      * The entity deconstructor
@@ -71,8 +75,9 @@ public:
      * Render the entity on the window
      * 
      * @param window The window to render the entity on
+     * @param alpha How far between the previous and current update to draw, 0 to 1
      */
-    void render(sf::RenderWindow& window);
+    void render(sf::RenderWindow& window, float alpha = 1);
 
 
     /**
@@ -114,6 +119,11 @@ public:
      */
     Kinematic getKinematic();
 
+    /**
+     * Get the entity's slot in the kinematic store
+     */
+    int getSlot() const;
+
     /**
      * Completely set the kinematic struct of the entity
      */
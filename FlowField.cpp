@@ -0,0 +1,221 @@
+#include "FlowField.h"
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include "Graph.h"
+#include "OccupancyGrid.h"
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+FlowField::FlowField() : goal(-1) {
+}
+
+/**
+ * Dijkstra from goal over ids [0, count), settling every reachable id. expand(u, relax) must call
+ * relax(v, weight) for every move from v into u, so the search runs against the direction of travel
+ */
+template <typename Expand>
+static void reverseDijkstra(int count, int goal, std::vector<float>& distances, std::vector<int>& nextHops, Expand&& expand) {
+    distances.assign(count, INF);
+    nextHops.assign(count, -1);
+    if (goal < 0 || goal >= count) return;
+
+    std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>> openList;
+    distances[goal] = 0;
+    openList.push({0, goal});
+
+    while (!openList.empty()) {
+        auto [distance, u] = openList.top();
+        openList.pop();
+
+        // A shorter distance was recorded after this entry was queued
+        if (distance > distances[u]) continue;
+
+        expand(u, [&](int v, float weight) {
+            if (v < 0 || v >= count) return;
+
+            float newDist = distance + weight;
+            if (newDist < distances[v]) {
+                distances[v] = newDist;
+                nextHops[v] = u;
+                openList.push({newDist, v});
+            }
+        });
+    }
+}
+
+void FlowField::build(const Graph& graph, int goalVertex) {
+    goal = goalVertex;
+    int count = graph.getVertexCount();
+
+    if (!graph.isDirectedGraph()) {
+        // Undirected edges are stored both ways, so the outgoing edges of u are also its incoming ones
+        reverseDijkstra(count, goal, distances, nextHops, [&](int u, auto&& relax) {
+            graph.forEachNeighbor(u, relax);
+        });
+        return;
+    }
+
+    // Directed graphs only store outgoing edges; gather the incoming ones once for the whole search
+    std::vector<int> offsets(count + 1, 0);
+    for (int u = 0; u < count; u++) {
+        graph.forEachNeighbor(u, [&](int v, float) {
+            if (v >= 0 && v < count) offsets[v + 1]++;
+        });
+    }
+    for (int v = 0; v < count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    std::vector<int> sources(offsets[count]);
+    std::vector<float> weights(offsets[count]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int u = 0; u < count; u++) {
+        graph.forEachNeighbor(u, [&](int v, float weight) {
+            if (v < 0 || v >= count) return;
+            sources[fill[v]] = u;
+            weights[fill[v]] = weight;
+            fill[v]++;
+        });
+    }
+
+    reverseDijkstra(count, goal, distances, nextHops, [&](int u, auto&& relax) {
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            relax(sources[e], weights[e]);
+        }
+    });
+}
+
+void FlowField::build(const OccupancyGrid& grid, int goalCell) {
+    goal = goalCell;
+    int rows = grid.getRows();
+    int cols = grid.getCols();
+
+    float straightX = grid.getCellWidth();
+    float straightY = grid.getCellHeight();
+    float diagonal = std::sqrt(straightX * straightX + straightY * straightY);
+
+    if (goal >= 0 && goal < rows * cols && !grid.isOpen(goal / cols, goal % cols)) {
+        distances.assign(rows * cols, INF);
+        nextHops.assign(rows * cols, -1);
+        return;
+    }
+
+    // Moves are symmetric, so the neighbors of u are exactly the tiles that can step into it
+    reverseDijkstra(rows * cols, goal, distances, nextHops, [&](int u, auto&& relax) {
+        int row = u / cols;
+        int col = u % cols;
+
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {
+                if (dr == 0 && dc == 0) continue;
+                if (!grid.isOpen(row + dr, col + dc)) continue;
+
+                // Diagonal moves need both orthogonal tiles open so agents do not clip wall corners
+                if (dr != 0 && dc != 0 && (!grid.isOpen(row + dr, col) || !grid.isOpen(row, col + dc))) continue;
+
+                float weight = dr == 0 ? straightX : dc == 0 ? straightY : diagonal;
+                relax(grid.cellId(row + dr, col + dc), weight);
+            }
+        }
+    });
+}
+
+int FlowField::getGoal() const {
+    return goal;
+}
+
+int FlowField::size() const {
+    return distances.size();
+}
+
+float FlowField::getDistance(int id) const {
+    if (id < 0 || id >= (int) distances.size()) return INF;
+    return distances[id];
+}
+
+int FlowField::getNextHop(int id) const {
+    if (id < 0 || id >= (int) nextHops.size()) return -1;
+    return nextHops[id];
+}
+
+bool FlowField::getPath(int start, Path& path) const {
+    path.vertices.clear();
+    path.distance = 0;
+
+    if (getDistance(start) == INF) return false;
+
+    for (int current = start; current != -1; current = nextHops[current]) {
+        path.vertices.push_back(current);
+    }
+    path.distance = distances[start];
+
+    return true;
+}
+
+sf::Vector2f FlowField::getDirection(const OccupancyGrid& grid, const sf::Vector2f& position) const {
+    int cell = grid.cellAt(position);
+    if (getDistance(cell) == INF) return sf::Vector2f(0, 0);
+
+    int next = nextHops[cell];
+    sf::Vector2f offset = grid.cellCenter(next == -1 ? cell : next) - position;
+
+    float length = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+    if (length == 0) return sf::Vector2f(0, 0);
+    return offset / length;
+}
+
+FlowFieldCache::FlowFieldCache(size_t capacity) : capacity(capacity), hits(0), misses(0) {
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::find(int goal) {
+    for (auto it = fields.begin(); it != fields.end(); it++) {
+        if ((*it)->getGoal() != goal) continue;
+
+        // Move to the front as the most recently used
+        fields.splice(fields.begin(), fields, it);
+        hits++;
+        return fields.front();
+    }
+
+    misses++;
+    return nullptr;
+}
+
+void FlowFieldCache::insert(std::shared_ptr<const FlowField> field) {
+    if (capacity == 0) return;
+
+    fields.remove_if([&](const std::shared_ptr<const FlowField>& cached) {
+        return cached->getGoal() == field->getGoal();
+    });
+    fields.push_front(field);
+
+    if (fields.size() > capacity) {
+        fields.pop_back();
+    }
+}
+
+void FlowFieldCache::clear() {
+    fields.clear();
+}
+
+void FlowFieldCache::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    while (fields.size() > capacity) {
+        fields.pop_back();
+    }
+}
+
+size_t FlowFieldCache::size() const {
+    return fields.size();
+}
+
+long FlowFieldCache::getHits() const {
+    return hits;
+}
+
+long FlowFieldCache::getMisses() const {
+    return misses;
+}
@@ -0,0 +1,131 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <SFML/Graphics.hpp>
+#include <list>
+#include <memory>
+#include <vector>
+#include "PathCache.h"
+
+class Graph;
+class OccupancyGrid;
+
+/**
+ * Distance to one goal and the next hop towards it from every vertex or grid cell.
+ *
+ * Built by a single reverse Dijkstra from the goal, so any number of agents
+ * heading to the same goal share one search and only read a table each frame.
+ */
+class FlowField {
+private:
+    /** The vertex or cell every hop leads to */
+    int goal;
+    /** Cost to the goal, infinity if unreachable */
+    std::vector<float> distances;
+    /** Neighbor one step closer to the goal, -1 at the goal or if unreachable */
+    std::vector<int> nextHops;
+
+public:
+
+    FlowField();
+
+    /**
+     * Fill the field for a graph, following edges backward from goal
+     *
+     * @param graph The graph to search
+     * @param goal The vertex every hop leads to
+     */
+    void build(const Graph& graph, int goal);
+
+    /**
+     * Fill the field for a tile grid. Moves go to the 8 neighboring open tiles,
+     * without cutting the corner of a wall, and cost the world distance between tile centers
+     *
+     * @param grid The grid to search
+     * @param goalCell The cell id every hop leads to
+     */
+    void build(const OccupancyGrid& grid, int goalCell);
+
+    int getGoal() const;
+
+    /**
+     * Number of vertices or cells covered
+     */
+    int size() const;
+
+    /**
+     * Get the cost from id to the goal, infinity if unreachable or not covered
+     */
+    float getDistance(int id) const;
+
+    /**
+     * Get the neighbor one step closer to the goal, -1 at the goal or if unreachable
+     */
+    int getNextHop(int id) const;
+
+    /**
+     * Fill path with the hops from start to the goal
+     *
+     * @return if the goal is reachable from start
+     */
+    bool getPath(int start, Path& path) const;
+
+    /**
+     * Get the unit direction from a world position towards the center of the next tile
+     * on a grid field, or towards the goal tile's center once inside it. Zero if unreachable
+     */
+    sf::Vector2f getDirection(const OccupancyGrid& grid, const sf::Vector2f& position) const;
+};
+
+/**
+ * Least-recently-used set of flow fields keyed by goal.
+ *
+ * Fields are shared and immutable, so agents can keep following one after it is evicted.
+ */
+class FlowFieldCache {
+private:
+    /** Maximum number of fields kept; each one holds two values per vertex or cell */
+    size_t capacity;
+    /** Fields ordered from most to least recently used */
+    std::list<std::shared_ptr<const FlowField>> fields;
+    /** Lookup statistics */
+    long hits;
+    long misses;
+
+public:
+
+    /**
+     * @param capacity The maximum number of fields to keep
+     */
+    FlowFieldCache(size_t capacity = 8);
+
+    /**
+     * Look up the field for a goal and mark it as recently used
+     *
+     * @return the field, or nullptr on a miss
+     */
+    std::shared_ptr<const FlowField> find(int goal);
+
+    /**
+     * Store a field, evicting the least recently used one when full
+     */
+    void insert(std::shared_ptr<const FlowField> field);
+
+    /**
+     * Drop every cached field
+     */
+    void clear();
+
+    /**
+     * Change the capacity, evicting fields if it shrinks
+     */
+    void setCapacity(size_t newCapacity);
+
+    size_t size() const;
+
+    long getHits() const;
+
+    long getMisses() const;
+};
+
+#endif
@@ -1,11 +1,22 @@
 #include "Game.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
+bool Game::headless = false;
 
-Game::Game() : window(sf::VideoMode(1000, 800), "SFML Window") {
+Game::Game() : entityCount(0), monsterCount(0), learningMonsterCount(0) {
 
+    if (!headless) {
+        window = std::make_unique<sf::RenderWindow>(sf::VideoMode(1000, 800), "SFML Window");
+    }
 
     arriveDistance = 10.0;
     slowDistance = 50.0;
+    pathBudget = 2000;
+    fixedTimestep = 1.0f / 60;
+    accumulator = 0;
+    maxUpdatesPerFrame = 5;
 
     // Override Already existing Data
     std::ofstream clearFile("DataFiles/monsterData.csv", std::ios::trunc);
@@ -45,10 +56,10 @@ Game& Game::getInstance() {
 
 void Game::processEvents() {
     sf::Event event;
-    while (window.pollEvent(event))
+    while (window->pollEvent(event))
     {
         if (event.type == sf::Event::Closed)
-            window.close();
+            window->close();
 
         
         if (event.type == sf::Event::KeyPressed) {
@@ -132,6 +143,13 @@ void Game::update(float deltaTime) {
         spawnEntity(0, 0);
     }
 
+    // Agents only pick steering until the integration below, so one snapshot serves every query
+    agentGrid.rebuild(kinematics);
+    entityInSlot.assign(kinematics.size(), nullptr);
+    for (auto entity : entities) {
+        entityInSlot[entity->getSlot()] = entity;
+    }
+
     for (unsigned int i = 0; i < entities.size(); i++) {
         Entity* entity = entities.at(i);
         entity->update(deltaTime);
@@ -146,46 +164,104 @@ void Game::update(float deltaTime) {
         LearningMonster* learningMonster = learningMonsters.at(i);
         learningMonster->update(deltaTime);
     }
+
+    // Every agent has picked its steering; move them all in one pass
+    kinematics.integrate(deltaTime);
 }
 
 
-void Game::render() {
+void Game::render(float alpha) {
 
     // Clear the window 
-    window.clear(sf::Color::White);
+    window->clear(sf::Color::White);
 
     // draw everything here
     for (auto breadcrumb : waters) {
-        breadcrumb->render(window);
+        breadcrumb->render(*window);
     }
 
     for (auto entity : entities) {
-        entity->render(window);
+        entity->render(*window, alpha);
     }
 
     for (auto monster : monsters) {
-        monster->render(window);
+        monster->render(*window, alpha);
     }
 
     for (auto learningMonster : learningMonsters) {
-        learningMonster->render(window);
+        learningMonster->render(*window, alpha);
     }
     // end the current frame
-    window.display();
+    window->display();
 }
 
 
 void Game::run() {
 
     // Game loop
-    while (window.isOpen())
+    while (window && window->isOpen())
     {
-        float deltaTime = clock.restart().asSeconds();
+        accumulator += clock.restart().asSeconds();
         processEvents();
+
+        // Path searches get a fixed slice of each frame however many agents are waiting on one,
+        // and however many updates the frame catches up below
+        pathScheduler.update(pathBudget);
+
+        // Simulate in fixed steps whatever the frame rate. After a hitch only a few steps are
+        // caught up and the rest of the backlog is dropped, so slow updates cannot snowball
+        int updates = 0;
+        while (accumulator >= fixedTimestep && updates < maxUpdatesPerFrame) {
+            update(fixedTimestep);
+            accumulator -= fixedTimestep;
+            updates++;
+        }
+        if (accumulator >= fixedTimestep) {
+            accumulator = std::fmod(accumulator, fixedTimestep);
+        }
+
+        // Draw the fraction of a step that has passed since the last update
+        render(accumulator / fixedTimestep);
+    }
+
+}
+
+double Game::runHeadless(long ticks, float deltaTime) {
+    using Clock = std::chrono::steady_clock;
+
+    auto begin = Clock::now();
+    for (long tick = 0; tick < ticks; tick++) {
+        // With no frames, every tick gets the budget a frame would
+        pathScheduler.update(pathBudget);
         update(deltaTime);
-        render();
     }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
 
+    return seconds > 0 ? ticks / seconds : 0;
+}
+
+void Game::setTickRate(float ticksPerSecond) {
+    if (ticksPerSecond > 0) fixedTimestep = 1 / ticksPerSecond;
+}
+
+float Game::getFixedTimestep() const {
+    return fixedTimestep;
+}
+
+void Game::setMaxUpdatesPerFrame(int updates) {
+    maxUpdatesPerFrame = std::max(updates, 1);
+}
+
+void Game::setHeadless(bool enabled) {
+    headless = enabled;
+}
+
+bool Game::isHeadless() const {
+    return !window;
+}
+
+std::string Game::assetPath(const std::string& path) const {
+    return window ? path : "";
 }
 
 std::vector<Entity*> Game::getEntities() {
@@ -203,72 +279,50 @@ std::vector<LearningMonster*> Game::getLearningMonsters() {
 void Game::spawnEntity(float x, float y) {
 
     // Load in the enemy
-    Entity *newEntity = new Entity(entityCount, "Assets/low_res-sprite.png", sf::Vector2f(x, y));
+    Entity *newEntity = new Entity(entityCount, assetPath("Assets/low_res-sprite.png"), sf::Vector2f(x, y), kinematics);
     entityCount += 1;
     entities.push_back(newEntity);
 }
 
 void Game::spawnMonster(float x, float y) {
 
-    Monster *newMonster = new Monster(monsterCount, "Assets/monster-sprite.png", sf::Vector2f(x, y), 200);
+    Monster *newMonster = new Monster(monsterCount, assetPath("Assets/monster-sprite.png"), sf::Vector2f(x, y), 200, kinematics);
     monsterCount += 1;
     monsters.push_back(newMonster);
 }
 
 void Game::spawnLearningMonster(float x, float y, std::string dataFile) {
 
-    LearningMonster *newMonster = new LearningMonster(learningMonsterCount, "Assets/monster-sprite.png", sf::Vector2f(x, y), 200, dataFile);
+    LearningMonster *newMonster = new LearningMonster(learningMonsterCount, assetPath("Assets/monster-sprite.png"), sf::Vector2f(x, y), 200, dataFile, kinematics);
     learningMonsterCount += 1;
     learningMonsters.push_back(newMonster);
 }
 
 void Game::checkOutOfBounds() {
+    kinematics.wrap(1000, 800, 5);
+}
 
-    for (auto entity : entities) {
-        sf::Vector2f entityPos = entity->getKinematic().position;
-        if (entity->getKinematic().position.x < -5) {
-            entity->setPosition(sf::Vector2f(1000, entityPos.y));
-        }
-        else if (entity->getKinematic().position.x > 1005) {
-            entity->setPosition(sf::Vector2f(0, entityPos.y));
-        }
-        if (entity->getKinematic().position.y < -5) {
-            entity->setPosition(sf::Vector2f(entityPos.x, 800));
-        }
-        else if (entity->getKinematic().position.y > 805) {
-            entity->setPosition(sf::Vector2f(entityPos.x, 0));
-        }
-    }
-    for (auto monster : monsters) {
-        sf::Vector2f monsterPos = monster->getKinematic().position;
-        if (monster->getKinematic().position.x < -5) {
-            monster->setPosition(sf::Vector2f(800, monsterPos.y));
-        }
-        else if (monster->getKinematic().position.x > 1005) {
-            monster->setPosition(sf::Vector2f(0, monsterPos.y));
-        }
-        if (monster->getKinematic().position.y < -5) {
-            monster->setPosition(sf::Vector2f(monsterPos.x, 800));
-        }
-        else if (monster->getKinematic().position.y > 805) {
-            monster->setPosition(sf::Vector2f(monsterPos.x, 0));
-        }
-    }
-    for (auto monster : learningMonsters) {
-        sf::Vector2f monsterPos = monster->getKinematic().position;
-        if (monster->getKinematic().position.x < -5) {
-            monster->setPosition(sf::Vector2f(800, monsterPos.y));
-        }
-        else if (monster->getKinematic().position.x > 1005) {
-            monster->setPosition(sf::Vector2f(0, monsterPos.y));
-        }
-        if (monster->getKinematic().position.y < -5) {
-            monster->setPosition(sf::Vector2f(monsterPos.x, 800));
-        }
-        else if (monster->getKinematic().position.y > 805) {
-            monster->setPosition(sf::Vector2f(monsterPos.x, 0));
-        }
+const KinematicStore& Game::getKinematics() const {
+    return kinematics;
+}
+
+const SpatialHash& Game::getAgentGrid() const {
+    return agentGrid;
+}
+
+std::vector<Entity*> Game::getEntitiesNear(const sf::Vector2f& position, float radius) {
+    std::vector<int> slots;
+    agentGrid.queryRadius(position, radius, KinematicStore::ENTITY, slots);
+
+    // Ids count up as entities spawn, while freed slots are handed out again in any order
+    const int* ids = kinematics.getIds();
+    std::sort(slots.begin(), slots.end(), [&](int a, int b) { return ids[a] < ids[b]; });
+
+    std::vector<Entity*> found;
+    for (int slot : slots) {
+        if (slot < (int) entityInSlot.size() && entityInSlot[slot]) found.push_back(entityInSlot[slot]);
     }
+    return found;
 }
 
 void Game::setSteeringBehavior(STEERING_TYPE steeringChoice) {
@@ -286,7 +340,7 @@ void Game::setSteeringBehavior(STEERING_TYPE steeringChoice) {
     
     else if (steeringChoice == VELOCITY) {
         velocityStruct.timeLeft = 1;
-        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        sf::Vector2i mousePos = window ? sf::Mouse::getPosition(*window) : sf::Vector2i(0, 0);
         sf::Vector2f mousePosFloat = sf::Vector2f((float) mousePos.x, (float) mousePos.y);
         velocityStruct.prevLoc = mousePosFloat;
         velocityStruct.nextLoc = mousePosFloat;
@@ -332,8 +386,7 @@ void Game::setSteeringBehavior(STEERING_TYPE steeringChoice) {
             entities.clear();
         }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        std::default_random_engine& gen = VectorUtils::randomEngine();
         std::uniform_real_distribution<float> dist(200, 500);
 
         for (int i = 0; i < 30; i++) {
@@ -367,4 +420,12 @@ Breadcrumb* Game::getNearestWaterBreadcrumb(sf::Vector2f currentPos) {
         }
     }
     return closestBreadcrumb;
-}
\ No newline at end of file
+}
+
+PathScheduler& Game::getPathScheduler() {
+    return pathScheduler;
+}
+
+void Game::setPathBudget(long microseconds) {
+    pathBudget = microseconds;
+}
@@ -2,14 +2,18 @@
 #define GAME_H
 
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <vector>
 #include <random>
 #include <fstream>
 #include <sstream>
 #include "Breadcrumb.h"
 #include "Entity.h"
+#include "KinematicStore.h"
 #include "Monster.h"
 #include "LearningMonster.h"
+#include "PathRequest.h"
+#include "SpatialHash.h"
 #include "SteeringBehavior.h"
 #include "VelocityMatchStruct.h"
 
@@ -17,10 +21,18 @@ class Game {
 
 private:
 
-    /** The Render Window to View */
-    sf::RenderWindow window;
+    /** Set before the instance is created to run without a window or textures */
+    static bool headless;
+    /** The Render Window to View, null when headless */
+    std::unique_ptr<sf::RenderWindow> window;
     /** In Game clock for deltaTime */
     sf::Clock clock;
+    /** Kinematics of every entity and monster, integrated together each update */
+    KinematicStore kinematics;
+    /** Agent positions bucketed at the start of every update, for neighbor and vision queries */
+    SpatialHash agentGrid;
+    /** The entity in each kinematics slot as of the last grid rebuild, null for other slots */
+    std::vector<Entity*> entityInSlot;
     /** Vector of entities */
     std::vector<Entity*> entities;
     /** Vector of monsters */
@@ -41,6 +53,16 @@ private:
     float slowDistance;
     /** Velocity Match Struct for Velocity Matching */
     VelocityMatchStruct velocityStruct;
+    /** Path searches requested by agents, spread across frames */
+    PathScheduler pathScheduler;
+    /** Microseconds of path search allowed each rendered frame, or each headless tick */
+    long pathBudget;
+    /** Simulated seconds per update */
+    float fixedTimestep;
+    /** Real time that has passed but not been simulated yet */
+    float accumulator;
+    /** Most updates run in one frame to catch up; the rest of the backlog is dropped */
+    int maxUpdatesPerFrame;
 
     /**
      * The Game Class constructor. Initialize window, variables, etc.
@@ -68,8 +90,15 @@ private:
 
     /**
      * Render all objects in the scene in the window
+     *
+     * @param alpha How far between the last two updates to draw the agents, 0 to 1
      */
-    void render();
+    void render(float alpha = 1);
+
+    /**
+     * The asset to load, or an empty path when headless
+     */
+    std::string assetPath(const std::string& path) const;
 
 
 public:
@@ -100,10 +129,46 @@ public:
     Game& operator=(const Game&) = delete;
 
     /**
-     * Method to run the main game loop
+     * Create the instance without a window or textures, for servers and CI. Only takes effect
+     * if called before the first getInstance()
+     */
+    static void setHeadless(bool enabled);
+
+    /**
+     * If the instance runs without a window
+     */
+    bool isHeadless() const;
+
+    /**
+     * Method to run the main game loop. The world updates at the fixed tick rate while frames
+     * render as fast as they come, interpolating the agents between updates
      */
     void run();
 
+    /**
+     * Set how many fixed updates run per simulated second
+     */
+    void setTickRate(float ticksPerSecond);
+
+    /**
+     * Simulated seconds per update
+     */
+    float getFixedTimestep() const;
+
+    /**
+     * Set how many updates a frame may run to catch up after a hitch
+     */
+    void setMaxUpdatesPerFrame(int updates);
+
+    /**
+     * Step the world a number of ticks as fast as the CPU allows, with no events or rendering
+     *
+     * @param ticks Number of updates to run
+     * @param deltaTime Simulated seconds per tick
+     * @return Ticks per second of wall time
+     */
+    double runHeadless(long ticks, float deltaTime);
+
     /**
      * Get the list of all entities
      */
@@ -135,10 +200,25 @@ public:
     void spawnLearningMonster(float x, float y, std::string dataFile);
 
     /**
-     * Check if the entity is out of bounds
+     * Wrap agents that left the screen to the opposite side
      */
     void checkOutOfBounds();
 
+    /**
+     * Get the kinematics of every agent, for scans over all of them
+     */
+    const KinematicStore& getKinematics() const;
+
+    /**
+     * Get the agent positions as of the start of this update, for local queries
+     */
+    const SpatialHash& getAgentGrid() const;
+
+    /**
+     * Get the entities within radius of a point as of the start of this update, in spawn order
+     */
+    std::vector<Entity*> getEntitiesNear(const sf::Vector2f& position, float radius);
+
     /**
      * Set the steering behavior based on user choice
      */
@@ -149,6 +229,17 @@ public:
      */
     Breadcrumb* getNearestWaterBreadcrumb(sf::Vector2f currentPos);
 
+    /**
+     * Get the scheduler agents queue path searches on. Results arrive over the following frames
+     */
+    PathScheduler& getPathScheduler();
+
+    /**
+     * Set the microseconds of path search allowed each rendered frame, however many updates
+     * it catches up. runHeadless allows it once per tick
+     */
+    void setPathBudget(long microseconds);
+
 };
 
 
@@ -1,21 +1,22 @@
 #include "Graph.h"
+#include <cstring>
 
 using namespace std;
 
 // Constructor
 
-Graph::Graph(std::string vertexPath, std::string edgePath, bool directed) : vertices(0), isDirected(directed), heuristicFunc(&Graph::euclideanHeuristic){
+Graph::Graph(std::string vertexPath, std::string edgePath, bool directed) : vertices(0), isDirected(directed), finalized(false), offsetData(nullptr), targetData(nullptr), weightData(nullptr), heuristicFunc(&Graph::euclideanHeuristic), heuristicType(EUCLIDEAN), useLandmarks(false), queueType(SearchContext::BINARY_HEAP), workerCount(0), nextListenerId(0), removedCount(0), compactions(0), trackIncoming(false), incomingStale(true){
 
     readVertices(vertexPath);
     readEdges(edgePath);
 }
 
-Graph::Graph(int V, bool directed) : vertices(0), isDirected(directed), heuristicFunc(&Graph::euclideanHeuristic) {
+Graph::Graph(int V, bool directed) : vertices(0), isDirected(directed), finalized(false), offsetData(nullptr), targetData(nullptr), weightData(nullptr), heuristicFunc(&Graph::euclideanHeuristic), heuristicType(EUCLIDEAN), useLandmarks(false), queueType(SearchContext::BINARY_HEAP), workerCount(0), nextListenerId(0), removedCount(0), compactions(0), trackIncoming(false), incomingStale(true) {
   generateRandomPositions(V);
 }
 
 
-Graph::Graph(bool directed) : vertices(0), isDirected(directed), heuristicFunc(&Graph::euclideanHeuristic) {
+Graph::Graph(bool directed) : vertices(0), isDirected(directed), finalized(false), offsetData(nullptr), targetData(nullptr), weightData(nullptr), heuristicFunc(&Graph::euclideanHeuristic), heuristicType(EUCLIDEAN), useLandmarks(false), queueType(SearchContext::BINARY_HEAP), workerCount(0), nextListenerId(0), removedCount(0), compactions(0), trackIncoming(false), incomingStale(true) {
 }
 
 void Graph::readVertices(std::string vertexPath) {
@@ -85,7 +86,7 @@ void Graph::readEdges(std::string edgePath) {
             int vID = static_cast<int>(row[1]);
             int distance = static_cast<int>(row[2]);
 
-            if (vertexPositions.find(uID) == vertexPositions.end() || vertexPositions.find(vID) == vertexPositions.end()) {
+            if (uID < 0 || uID >= vertices || vID < 0 || vID >= vertices) {
                 std::cerr << "Vertex ID not found: " << uID << " or " << vID << std::endl;
                 continue;
             }
@@ -96,6 +97,131 @@ void Graph::readEdges(std::string edgePath) {
     file.close();
 }
 
+void Graph::finalize() {
+
+    // Nothing has changed since the last finalize, and a mapped graph has no adjList to rebuild from
+    if (finalized) return;
+
+    // Count the out-degree of every vertex
+    csrOffsets.assign(vertices + 1, 0);
+    for (const auto& [u, neighbors] : adjList) {
+        if (u < 0 || u >= vertices) continue;
+        for (const auto& [v, weight] : neighbors) {
+            if (v >= 0 && v < vertices) csrOffsets[u + 1]++;
+        }
+    }
+
+    // Prefix sum turns degrees into offsets
+    for (int u = 0; u < vertices; u++) {
+        csrOffsets[u + 1] += csrOffsets[u];
+    }
+
+    csrTargets.resize(csrOffsets[vertices]);
+    csrWeights.resize(csrOffsets[vertices]);
+
+    // Copy the edges of each vertex into its contiguous slice
+    for (int u = 0; u < vertices; u++) {
+        auto it = adjList.find(u);
+        if (it == adjList.end()) continue;
+
+        int e = csrOffsets[u];
+        for (const auto& [v, weight] : it->second) {
+            if (v < 0 || v >= vertices) continue;
+            csrTargets[e] = v;
+            csrWeights[e] = weight;
+            e++;
+        }
+    }
+
+    offsetData = csrOffsets.data();
+    targetData = csrTargets.data();
+    weightData = csrWeights.data();
+    finalized = true;
+}
+
+bool Graph::isFinalized() {
+    return finalized;
+}
+
+bool Graph::saveBinary(std::string binaryPath) {
+    // The file has no tombstones, so removed vertices would come back live
+    compact();
+    finalize();
+
+    std::vector<float> positions;
+    positions.reserve(2 * vertices);
+    for (const Vertex& vertex : vertexPositions) {
+        positions.push_back(vertex.position.x);
+        positions.push_back(vertex.position.y);
+    }
+
+    return GraphFile::write(binaryPath, isDirected, vertices, positions, offsetData, targetData, weightData);
+}
+
+bool Graph::loadBinary(std::string binaryPath) {
+    auto file = std::make_unique<GraphFile>();
+    if (!file->open(binaryPath)) {
+        return false;
+    }
+
+    thaw();
+    adjList.clear();
+    vertexPositions.clear();
+    vertexGrid.clear();
+    pathCache.clear();
+    flowFields.clear();
+    landmarks.clear();
+    nextHops.clear();
+    removedVertices.clear();
+    removedCount = 0;
+    incoming.clear();
+    incomingStale = true;
+
+    isDirected = file->isDirected();
+    vertices = file->getVertexCount();
+
+    // Positions are copied so vertices keep their usual layout; the edges stay in the mapping
+    const float* xy = file->getPositions();
+    std::vector<sf::Vector2f> positions(vertices);
+    vertexPositions.reserve(vertices);
+    for (int v = 0; v < vertices; v++) {
+        positions[v] = sf::Vector2f(xy[2 * v], xy[2 * v + 1]);
+        vertexPositions.push_back({v, positions[v]});
+    }
+    vertexGrid.assign(positions);
+
+    offsetData = file->getOffsets();
+    targetData = file->getTargets();
+    weightData = file->getWeights();
+    graphFile = std::move(file);
+    finalized = true;
+
+    return true;
+}
+
+void Graph::thaw() {
+    if (!finalized) return;
+
+    // Mapped and generated edges were never in adjList; copy them there before the arrays go away
+    if (adjList.empty()) {
+        for (int u = 0; u < vertices; u++) {
+            for (int e = offsetData[u]; e < offsetData[u + 1]; e++) {
+                adjList[u].push_back({targetData[e], weightData[e]});
+            }
+        }
+        incomingStale = true;
+    }
+    graphFile.reset();
+
+    finalized = false;
+    csrOffsets.clear();
+    csrTargets.clear();
+    csrWeights.clear();
+    offsetData = nullptr;
+    targetData = nullptr;
+    weightData = nullptr;
+}
+
 // Generate random positions for vertices
 void Graph::generateRandomPositions(int count) {
     for (int i = 0; i < count; i++) {
@@ -124,42 +250,198 @@ void Graph::generateRandomPositions(int count) {
     }
 }
 
-int Graph::getVertexCount() {
+void Graph::generateSpatialGraph(int count, int k, unsigned seed, float worldSize) {
+    thaw();
+    adjList.clear();
+    vertexPositions.clear();
+    vertexGrid.clear();
+    pathCache.clear();
+    flowFields.clear();
+    landmarks.clear();
+    nextHops.clear();
+    removedVertices.clear();
+    removedCount = 0;
+    incoming.clear();
+    incomingStale = true;
+
+    vertices = std::max(count, 0);
+
+    // Scale the top 24 bits by hand; the standard distributions may differ between libraries
+    std::mt19937 engine(seed);
+    auto coordinate = [&]() { return (engine() >> 8) * (worldSize / 16777216.0f); };
+
+    std::vector<sf::Vector2f> positions(vertices);
+    vertexPositions.reserve(vertices);
+    for (int v = 0; v < vertices; v++) {
+        positions[v].x = coordinate();
+        positions[v].y = coordinate();
+        vertexPositions.push_back({v, positions[v]});
+    }
+    vertexGrid.assign(positions);
+
+    // Arcs to each vertex's k nearest neighbors. Undirected graphs store every link both ways, once
+    std::vector<std::pair<int, int>> arcs;
+    arcs.reserve((size_t) vertices * std::max(k, 0) * (isDirected ? 1 : 2));
+    for (int u = 0; u < vertices; u++) {
+        for (int v : vertexGrid.kNearest(positions[u], k + 1)) {
+            if (v == u) continue;
+            arcs.push_back({u, v});
+            if (!isDirected) arcs.push_back({v, u});
+        }
+    }
+    std::sort(arcs.begin(), arcs.end());
+    arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+    // The arcs are sorted by source, so they are already in CSR order
+    csrOffsets.assign(vertices + 1, 0);
+    csrTargets.resize(arcs.size());
+    csrWeights.resize(arcs.size());
+    for (size_t e = 0; e < arcs.size(); e++) {
+        const auto& [u, v] = arcs[e];
+        csrOffsets[u + 1]++;
+        csrTargets[e] = v;
+        csrWeights[e] = euclideanHeuristic(positions[u], positions[v]);
+    }
+    for (int u = 0; u < vertices; u++) {
+        csrOffsets[u + 1] += csrOffsets[u];
+    }
+
+    offsetData = csrOffsets.data();
+    targetData = csrTargets.data();
+    weightData = csrWeights.data();
+    finalized = true;
+}
+
+int Graph::getVertexCount() const {
     return vertices;
 }
 
-Vertex Graph::getVertex(int idx) {
+long Graph::getEdgeCount() const {
+    if (finalized) return offsetData[vertices];
+
+    long count = 0;
+    for (const auto& [u, neighbors] : adjList) {
+        count += neighbors.size();
+    }
+    return count;
+}
+
+Vertex Graph::getVertex(int idx) const {
+    if (idx < 0 || idx >= vertices) return Vertex{};
     return vertexPositions[idx];
 }
 
 void Graph::addVertex(float x, float y) {
+    thaw();
+    landmarks.clear();
+    nextHops.clear();
 
-    vertexPositions[vertices] = {vertices, sf::Vector2f(x, y)};
+    vertexPositions.push_back({vertices, sf::Vector2f(x, y)});
+    vertexGrid.insert(vertices, sf::Vector2f(x, y));
     vertices += 1;
 }
 
 
 // Add edge with weight
 void Graph::addEdge(int u, int v, float weight) {
+    if (isRemoved(u) || isRemoved(v)) return;
+
+    thaw();
+    pathCache.clear();
+    flowFields.clear();
+
+    // A new edge can shorten routes, so landmark bounds may overestimate. Removals keep them valid
+    landmarks.clear();
+
     adjList[u].push_back({v, weight});
     if (!isDirected) {
         adjList[v].push_back({u, weight});
     }
+    else if (trackIncoming && !incomingStale) {
+        incoming[v].push_back(u);
+    }
+
+    nextHops.edgeAdded(u, v, weight);
+    if (!isDirected) nextHops.edgeAdded(v, u, weight);
+
+    notifyEdgeChanged(u, v);
+    if (!isDirected) notifyEdgeChanged(v, u);
 }
 
 void Graph::removeVertex(int u) {
-    // Step 1: Remove the vertex from the adjacency list of all other vertices
-    for (auto& [id, neighbors] : adjList) {
-        neighbors.remove_if([u](const std::pair<int, float>& edge) {
-            return edge.first == u;  // Remove all occurrences of vertexId
+    if (u < 0 || u >= vertices || isRemoved(u)) return;
+
+    thaw();
+    pathCache.clear();
+    flowFields.clear();
+
+    std::vector<std::pair<int, int>> removed;
+    auto dropEdgesInto = [&](int source) {
+        auto it = adjList.find(source);
+        if (it == adjList.end()) return;
+        it->second.remove_if([&](const std::pair<int, float>& edge) {
+            if (edge.first != u) return false;
+            removed.push_back({source, u});
+            return true;
         });
+    };
+
+    // Step 1: Remove the vertex from the adjacency list of every vertex with an edge into it
+    if (!isDirected) {
+        std::vector<int> neighbors;
+        auto it = adjList.find(u);
+        if (it != adjList.end()) {
+            for (const auto& [v, weight] : it->second) {
+                neighbors.push_back(v);
+            }
+        }
+        for (int v : neighbors) {
+            dropEdgesInto(v);
+        }
+    }
+    else if (trackIncoming) {
+        prepareIncoming();
+        auto it = incoming.find(u);
+        if (it != incoming.end()) {
+            for (int source : it->second) {
+                dropEdgesInto(source);
+            }
+            incoming.erase(it);
+        }
+    }
+    else {
+        for (auto& [id, neighbors] : adjList) {
+            dropEdgesInto(id);
+        }
     }
 
     // Step 2: Remove the vertex itself from the adjacency list
-    adjList.erase(u);
+    auto it = adjList.find(u);
+    if (it != adjList.end()) {
+        for (const auto& [v, weight] : it->second) {
+            removed.push_back({u, v});
+            if (isDirected && trackIncoming) eraseIncoming(v, u);
+        }
+        adjList.erase(it);
+    }
+
+    // Step 3: Stop snapping agents onto it and tombstone its id
+    vertexGrid.remove(u);
+    if (removedVertices.size() < (size_t) vertices) removedVertices.resize(vertices, 0);
+    removedVertices[u] = 1;
+    removedCount++;
+
+    for (const auto& [from, to] : removed) {
+        nextHops.edgeRemoved(from, to);
+        notifyEdgeChanged(from, to);
+    }
 }
 
 void Graph::removeEdge(int u, int v) {
+    thaw();
+    pathCache.clear();
+    flowFields.clear();
+
     // Step 1: Remove edge u -> v
     auto& neighborsU = adjList[u];
     neighborsU.remove_if([v](const std::pair<int, float>& edge) {
@@ -172,29 +454,159 @@ void Graph::removeEdge(int u, int v) {
         return edge.first == u;  // Check if the neighbor is u
     });
 
+    if (isDirected && trackIncoming && !incomingStale) {
+        eraseIncoming(v, u);
+        eraseIncoming(u, v);
+    }
+
+    nextHops.edgeRemoved(u, v);
+    nextHops.edgeRemoved(v, u);
+
+    notifyEdgeChanged(u, v);
+    notifyEdgeChanged(v, u);
+}
+
+int Graph::getRemovedVertexCount() const {
+    return removedCount;
+}
+
+void Graph::setMutable(bool enabled) {
+    trackIncoming = enabled;
+    incoming.clear();
+    incomingStale = true;
+}
+
+bool Graph::isMutable() const {
+    return trackIncoming;
+}
+
+void Graph::prepareIncoming() {
+    if (!incomingStale) return;
+
+    incoming.clear();
+    for (const auto& [u, neighbors] : adjList) {
+        for (const auto& [v, weight] : neighbors) {
+            incoming[v].push_back(u);
+        }
+    }
+    incomingStale = false;
+}
+
+void Graph::eraseIncoming(int target, int source) {
+    auto it = incoming.find(target);
+    if (it == incoming.end()) return;
+
+    auto& sources = it->second;
+    sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
+}
+
+std::vector<int> Graph::compact() {
+    std::vector<int> newIds(vertices, -1);
+    if (removedCount == 0) {
+        for (int v = 0; v < vertices; v++) newIds[v] = v;
+        return newIds;
+    }
+
+    thaw();
+    pathCache.clear();
+    flowFields.clear();
+    landmarks.clear();
+    nextHops.clear();
+
+    int live = 0;
+    for (int v = 0; v < vertices; v++) {
+        if (!isRemoved(v)) newIds[v] = live++;
+    }
+
+    std::vector<Vertex> positions;
+    std::vector<sf::Vector2f> gridPositions;
+    positions.reserve(live);
+    gridPositions.reserve(live);
+    for (int v = 0; v < vertices; v++) {
+        if (newIds[v] == -1) continue;
+        positions.push_back({newIds[v], vertexPositions[v].position});
+        gridPositions.push_back(vertexPositions[v].position);
+    }
+
+    // Removed vertices have no edges left, so every endpoint maps to a live id
+    std::unordered_map<int, std::list<std::pair<int, float>>> renumbered;
+    for (auto& [u, neighbors] : adjList) {
+        if (neighbors.empty()) continue;
+        auto& list = renumbered[newIds[u]];
+        for (const auto& [v, weight] : neighbors) {
+            list.push_back({newIds[v], weight});
+        }
+    }
+
+    adjList = std::move(renumbered);
+    vertexPositions = std::move(positions);
+    vertexGrid.assign(gridPositions);
+    vertices = live;
+    removedVertices.clear();
+    removedCount = 0;
+    incoming.clear();
+    incomingStale = true;
+    compactions++;
+
+    for (auto& [id, listener] : remapListeners) {
+        listener(newIds);
+    }
+
+    return newIds;
+}
+
+int Graph::getCompactionCount() const {
+    return compactions;
+}
+
+bool Graph::isDirectedGraph() const {
+    return isDirected;
+}
+
+int Graph::addEdgeListener(std::function<void(int, int)> listener) {
+    edgeListeners[nextListenerId] = listener;
+    return nextListenerId++;
+}
+
+void Graph::removeEdgeListener(int id) {
+    edgeListeners.erase(id);
+}
+
+int Graph::addRemapListener(std::function<void(const std::vector<int>&)> listener) {
+    remapListeners[nextListenerId] = listener;
+    return nextListenerId++;
+}
+
+void Graph::removeRemapListener(int id) {
+    remapListeners.erase(id);
+}
+
+void Graph::notifyEdgeChanged(int u, int v) {
+    for (auto& [id, listener] : edgeListeners) {
+        listener(u, v);
+    }
 }
 
 // Draw the graph using SFML
 void Graph::drawGraph(sf::RenderWindow &window) {
 
     // Draw edges
-    for (auto &node : adjList) {
-        int u = node.first;
+    for (int u = 0; u < vertices; u++) {
         sf::Vector2f posU = vertexPositions[u].position;
-        for (auto &neighbor : node.second) {
-            int v = neighbor.first;
-            sf::Vector2f posV = vertexPositions[v].position;
+        forEachNeighbor(u, [&](int v, float) {
+            sf::Vector2f posV = getPosition(v);
 
             sf::Vertex line[] = {sf::Vertex(posU, sf::Color::Blue), sf::Vertex(posV, sf::Color::Blue)};
-            window.draw(line, 3, sf::Lines);
-        }
+            window.draw(line, 2, sf::Lines);
+        });
     }
 
     // Draw vertices
-    for (auto &node : vertexPositions) {
+    for (auto &vertex : vertexPositions) {
+        if (isRemoved(vertex.id)) continue;
 
-        int id = node.first;
-        sf::Vector2f pos = node.second.position;
+        int id = vertex.id;
+        sf::Vector2f pos = vertex.position;
 
         sf::CircleShape circle(8);
 
@@ -226,142 +638,387 @@ int Graph::calculateDistance(Vertex u, Vertex v) {
 
 
 // Get position of a vertex
-sf::Vector2f Graph::getPosition(int v) {
-    return vertexPositions[v].position;
+sf::Vector2f Graph::getPosition(int v) const {
+    return getVertex(v).position;
 }
 
 Vertex Graph::getClosestVertex(int xPos, int yPos) {
+    int closest = vertexGrid.nearest(sf::Vector2f(xPos, yPos));
+    return getVertex(closest == -1 ? 0 : closest);
+}
 
-    float shortestDistance = std::numeric_limits<float>::infinity();;
-    Vertex closestVertex = vertexPositions[0];
-
-    for (auto& [pos, vertex] : vertexPositions) {
-        float xDistance = abs(vertex.position.x - xPos);
-        float yDistance = abs(vertex.position.y - yPos);
-        
-        float squared = pow(xDistance, 2) + pow(yDistance, 2);
-        float root = sqrt(squared);
+std::vector<int> Graph::getClosestVertices(float x, float y, int k) const {
+    return vertexGrid.kNearest(sf::Vector2f(x, y), k);
+}
 
-        if (root < shortestDistance) {
-            shortestDistance = root;
-            closestVertex = vertex;
-        }
-    }
 
-    return closestVertex;
+int Graph::dijkstra(int start, int end) {
+  if (!nextHops.empty()) return lookupNextHop(start, end);
+  return dijkstra(start, end, searchContext);
 }
 
+int Graph::dijkstra(int start, int end, SearchContext& context) const {
+  if (!searchDijkstra(start, end, context)) return -1;
+  return firstStep(start, end, context);
+}
 
-int Graph::dijkstra(int start, int end) {
-  
-  std::unordered_map<int, float> distances;
-  std::unordered_map<int, int> prev; // Store previous node in path
-  std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<>> pq;
+bool Graph::searchDijkstra(int start, int end, SearchContext& context) const {
 
-  // Initialize distances as infinity
-  for (const auto& [node, _] : adjList) {
-      distances[node] = std::numeric_limits<float>::infinity();
-  }
+  if (start < 0 || start >= vertices || end < 0 || end >= vertices) return false;
 
-  distances[start] = 0;
-  pq.emplace(0, start);
+  // Unseen vertices read as infinity, so there is nothing to initialize
+  context.begin(vertices);
+  context.relax(start, 0, 0, -1);
 
-  while (!pq.empty()) {
-      auto [currDistance, currNode] = pq.top();
-      pq.pop();
+  while (!context.empty()) {
+      auto entry = context.pop();
+      int currNode = entry.second;
 
       // If we reached the end node, break early
       if (currNode == end) break;
 
-      // If distance is greater than recorded shortest distance, skip
-      if (currDistance > distances[currNode]) continue;
+      // If a shorter distance was recorded after this entry was queued, skip
+      if (context.isStale(entry)) continue;
+
+      float currDistance = context.getDistance(currNode);
 
       // Traverse neighbors
-      for (const auto& [neighbor, weight] : adjList.at(currNode)) {
+      forEachNeighbor(currNode, [&](int neighbor, float weight) {
           float newDist = currDistance + weight;
 
-          if (newDist < distances[neighbor]) {
-              distances[neighbor] = newDist;
-              prev[neighbor] = currNode; // Store previous node
-              pq.emplace(newDist, neighbor);
+          if (newDist < context.getDistance(neighbor)) {
+              context.relax(neighbor, newDist, newDist, currNode);
           }
-      }
+      });
   }
 
-  // If the end node was never reached, return std::nullopt
-  if (prev.find(end) == prev.end()) return -1;
+  return context.getDistance(end) < std::numeric_limits<float>::infinity();
+}
 
-  // Reconstruct path by backtracking from end to start
-  int current = end;
-  int firstStep = end; // Default to end if no valid path
+int Graph::astar(int start, int end) {
+    if (!nextHops.empty()) return lookupNextHop(start, end);
+    return astar(start, end, searchContext);
+}
 
-  while (prev.find(current) != prev.end()) {
-      if (prev[current] == start) {
-          firstStep = current; // First move from start
-          break;
-      }
-      current = prev[current];
-  }
+int Graph::astar(int start, int end, SearchContext& context) const {
+    if (!searchAstar(start, end, context)) return -1;
+    return firstStep(start, end, context);
+}
 
-  return firstStep;
+bool Graph::searchAstar(int start, int end, SearchContext& context) const {
+
+    if (start < 0 || start >= vertices || end < 0 || end >= vertices) return false;
+
+    // Pick the heuristic once; the search loop is compiled separately for each one
+    return withHeuristic(start, end, [&](const auto& toEnd, const auto&) {
+        return searchAstar(start, end, context, toEnd);
+    });
 }
 
-int Graph::astar(int start, int end) {
-    std::unordered_map<int, float> gScore; // Cost from start to this node
-    std::unordered_map<int, float> fScore; // Estimated total cost to goal
-    std::unordered_map<int, int> prev; // Stores previous node in path
-    std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<>> pq;
+template <typename Search>
+bool Graph::withHeuristic(int start, int end, Search&& search) const {
+    if (useLandmarks && !landmarks.empty()) {
+        return search(LandmarkTable::GoalBound(landmarks, end), LandmarkTable::GoalBound(landmarks, start));
+    }
 
-    // Initialize distances as infinity
-    for (const auto& [node, _] : adjList) {
-        gScore[node] = std::numeric_limits<float>::infinity();
-        fScore[node] = std::numeric_limits<float>::infinity();
+    PositionHeuristic toEnd{vertexPositions.data(), vertexPositions[end].position};
+    PositionHeuristic toStart{vertexPositions.data(), vertexPositions[start].position};
+    switch (heuristicType) {
+        case MANHATTAN: return search(ManhattanEstimate{toEnd}, ManhattanEstimate{toStart});
+        case OCTILE: return search(OctileEstimate{toEnd}, OctileEstimate{toStart});
+        case SQUARED_EUCLIDEAN: return search(SquaredEuclideanEstimate{toEnd}, SquaredEuclideanEstimate{toStart});
+        case CUSTOM: return search(CustomEstimate{toEnd, &heuristicFunc}, CustomEstimate{toStart, &heuristicFunc});
+        default: return search(EuclideanEstimate{toEnd}, EuclideanEstimate{toStart});
     }
+}
+
+template <typename Heuristic>
+bool Graph::searchAstar(int start, int end, SearchContext& context, const Heuristic& estimate) const {
 
-    gScore[start] = 0;
-    fScore[start] = heuristic(start, end); // Initial heuristic estimate
-    pq.emplace(fScore[start], start);
+    // gScore lives in the context distances, fScore in its keys
+    context.begin(vertices);
+    context.relax(start, 0, estimate(start), -1);
 
-    while (!pq.empty()) {
-        auto [currFScore, currNode] = pq.top();
-        pq.pop();
+    while (!context.empty()) {
+        auto entry = context.pop();
+        int currNode = entry.second;
 
         if (currNode == end) break; // Reached destination
 
-        for (const auto& [neighbor, weight] : adjList.at(currNode)) {
-            float tentative_gScore = gScore[currNode] + weight;
+        if (context.isStale(entry)) continue;
+
+        float currGScore = context.getDistance(currNode);
+
+        forEachNeighbor(currNode, [&](int neighbor, float weight) {
+            float tentative_gScore = currGScore + weight;
 
-            if (tentative_gScore < gScore[neighbor]) {
-                gScore[neighbor] = tentative_gScore;
-                fScore[neighbor] = tentative_gScore + heuristic(neighbor, end);
-                prev[neighbor] = currNode;
-                pq.emplace(fScore[neighbor], neighbor);
+            if (tentative_gScore < context.getDistance(neighbor)) {
+                context.relax(neighbor, tentative_gScore, tentative_gScore + estimate(neighbor), currNode);
             }
-        }
+        });
+    }
+
+    return context.getDistance(end) < std::numeric_limits<float>::infinity();
+}
+
+int Graph::bidirectionalDijkstra(int start, int end) {
+    return bidirectionalDijkstra(start, end, searchContext, reverseContext);
+}
+
+int Graph::bidirectionalDijkstra(int start, int end, SearchContext& forward, SearchContext& backward) const {
+    int meeting;
+    if (!searchBidirectional(start, end, forward, backward, false, meeting)) return -1;
+    return firstStep(start, meeting, forward, backward);
+}
+
+int Graph::bidirectionalAstar(int start, int end) {
+    return bidirectionalAstar(start, end, searchContext, reverseContext);
+}
+
+int Graph::bidirectionalAstar(int start, int end, SearchContext& forward, SearchContext& backward) const {
+    int meeting;
+    if (!searchBidirectional(start, end, forward, backward, true, meeting)) return -1;
+    return firstStep(start, meeting, forward, backward);
+}
+
+bool Graph::findPathBidirectional(int start, int goal, Path& path, SearchContext& forward, SearchContext& backward) const {
+
+    path.vertices.clear();
+    path.distance = 0;
+
+    int meeting;
+    if (!searchBidirectional(start, goal, forward, backward, true, meeting)) return false;
+
+    // Forward links run from the meeting point back to start, backward links on to the goal
+    for (int current = meeting; current != -1; current = forward.getPrevious(current)) {
+        path.vertices.push_back(current);
+    }
+    std::reverse(path.vertices.begin(), path.vertices.end());
+    for (int current = backward.getPrevious(meeting); current != -1; current = backward.getPrevious(current)) {
+        path.vertices.push_back(current);
+    }
+    path.distance = forward.getDistance(meeting) + backward.getDistance(meeting);
+
+    return true;
+}
+
+bool Graph::searchBidirectional(int start, int end, SearchContext& forward, SearchContext& backward, bool useHeuristic, int& meeting) const {
+
+    meeting = -1;
+    if (start < 0 || start >= vertices || end < 0 || end >= vertices) return false;
+
+    // The backward search walks edges against their direction, which only the undirected adjacency stores
+    if (isDirected) {
+        backward.begin(vertices);
+        backward.relax(end, 0, 0, -1);
+        meeting = end;
+        return useHeuristic ? searchAstar(start, end, forward) : searchDijkstra(start, end, forward);
+    }
+
+    if (!useHeuristic) {
+        return searchBidirectional(start, end, forward, backward, ZeroEstimate{}, ZeroEstimate{}, meeting);
+    }
+    return withHeuristic(start, end, [&](const auto& toEnd, const auto& toStart) {
+        return searchBidirectional(start, end, forward, backward, toEnd, toStart, meeting);
+    });
+}
+
+template <typename Heuristic>
+bool Graph::searchBidirectional(int start, int end, SearchContext& forward, SearchContext& backward,
+                                const Heuristic& toEnd, const Heuristic& toStart, int& meeting) const {
+
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    // Average potentials keep both searches consistent with each other: forward keys are
+    // d(start, v) + forwardPotential(v), backward keys d(v, end) + offset - forwardPotential(v).
+    // The constants only keep keys non-negative, which the radix heap needs
+    float startOffset = toStart(end) / 2;
+    float offset = startOffset + toEnd(start) / 2;
+    auto forwardPotential = [&](int v) { return (toEnd(v) - toStart(v)) / 2 + startOffset; };
+
+    forward.begin(vertices);
+    backward.begin(vertices);
+    forward.relax(start, 0, forwardPotential(start), -1);
+    backward.relax(end, 0, offset - forwardPotential(end), -1);
+
+    // Shortest route found so far through any vertex both searches reached
+    float best = start == end ? 0 : infinity;
+    meeting = start == end ? start : -1;
+
+    // Keys pop in increasing order on each side, so once the last two popped cannot beat best nothing can
+    float lastForward = 0;
+    float lastBackward = 0;
+
+    bool forwardTurn = true;
+    while (!forward.empty() && !backward.empty()) {
+        SearchContext& context = forwardTurn ? forward : backward;
+        const SearchContext& other = forwardTurn ? backward : forward;
+        bool isForward = forwardTurn;
+        forwardTurn = !forwardTurn;
+
+        auto entry = context.pop();
+        if (context.isStale(entry)) continue;
+
+        (isForward ? lastForward : lastBackward) = entry.first;
+        if (lastForward + lastBackward - offset >= best) break;
+
+        int currNode = entry.second;
+        float currDistance = context.getDistance(currNode);
+
+        // Undirected edges are stored both ways, so the same neighbors serve the backward search
+        forEachNeighbor(currNode, [&](int neighbor, float weight) {
+            float newDist = currDistance + weight;
+            if (newDist >= context.getDistance(neighbor)) return;
+
+            float potential = forwardPotential(neighbor);
+            context.relax(neighbor, newDist, newDist + (isForward ? potential : offset - potential), currNode);
+
+            float through = newDist + other.getDistance(neighbor);
+            if (through < best) {
+                best = through;
+                meeting = neighbor;
+            }
+        });
     }
 
+    return best < infinity;
+}
+
+int Graph::firstStep(int start, int meeting, const SearchContext& forward, const SearchContext& backward) const {
+
+    // The route leaves start along the backward links when the searches met right at start
+    if (meeting == start) return backward.getPrevious(start);
+
+    return firstStep(start, meeting, forward);
+}
+
+int Graph::firstStep(int start, int end, const SearchContext& context) const {
+
     // If goal was never reached
-    if (prev.find(end) == prev.end()) return -1;
+    if (context.getPrevious(end) == -1) return -1;
 
     // Reconstruct path (return the first step from start to end)
     int current = end;
-    int firstStep = end;
+    while (context.getPrevious(current) != start) {
+        current = context.getPrevious(current);
+    }
 
-    while (prev.find(current) != prev.end()) {
-        if (prev[current] == start) {
-            firstStep = current;
-            break;
-        }
-        current = prev[current];
+    return current;
+}
+
+bool Graph::findPath(int start, int goal, Path& path, SearchContext& context) const {
+
+    path.vertices.clear();
+    path.distance = 0;
+
+    if (!searchAstar(start, goal, context)) return false;
+
+    // Backtrack from the goal, then flip into start -> goal order
+    for (int current = goal; current != -1; current = context.getPrevious(current)) {
+        path.vertices.push_back(current);
+    }
+    std::reverse(path.vertices.begin(), path.vertices.end());
+    path.distance = context.getDistance(goal);
+
+    return true;
+}
+
+std::shared_ptr<const Path> Graph::getPath(int start, int goal) {
+
+    std::shared_ptr<const Path> cached = pathCache.find(start, goal);
+    if (cached) return cached;
+
+    // Unreachable results are cached too, so repeated failed queries stay cheap
+    auto path = std::make_shared<Path>();
+    findPath(start, goal, *path, searchContext);
+    pathCache.insert(start, goal, path);
+
+    return path;
+}
+
+void Graph::setPathCacheCapacity(int capacity) {
+    pathCache.setCapacity(capacity < 0 ? 0 : capacity);
+}
+
+const PathCache& Graph::getPathCache() const {
+    return pathCache;
+}
+
+std::shared_ptr<const FlowField> Graph::getFlowField(int goal) {
+
+    std::shared_ptr<const FlowField> cached = flowFields.find(goal);
+    if (cached) return cached;
+
+    auto field = std::make_shared<FlowField>();
+    field->build(*this, goal);
+    flowFields.insert(field);
+
+    return field;
+}
+
+void Graph::setFlowFieldCapacity(int capacity) {
+    flowFields.setCapacity(capacity < 0 ? 0 : capacity);
+}
+
+const FlowFieldCache& Graph::getFlowFieldCache() const {
+    return flowFields;
+}
+
+void Graph::setWorkerCount(int count) {
+    workerCount = count < 0 ? 0 : count;
+    workerPool.reset();
+}
+
+WorkerPool& Graph::getWorkerPool() {
+    if (!workerPool) {
+        workerPool = std::make_unique<WorkerPool>(workerCount);
+        workerContexts.resize(workerPool->getWorkerCount(), SearchContext(queueType));
     }
+    return *workerPool;
+}
 
-    std::cout << start << "->" << firstStep << ": " << heuristic(start, firstStep) << std::endl;
+std::vector<int> Graph::batchQuery(const std::vector<std::pair<int, int>>& requests) {
+    std::vector<int> steps(requests.size(), -1);
 
-    return firstStep;
+    // Searches only read the graph; all mutable state lives in each worker's context
+    getWorkerPool().parallelFor(requests.size(), [&](int i, int worker) {
+        steps[i] = astar(requests[i].first, requests[i].second, workerContexts[worker]);
+    });
+    return steps;
 }
 
-float Graph::heuristic(int node, int goal) {
-    return heuristicFunc(getVertex(node).position, getVertex(goal).position);
+void Graph::batchQuery(const std::vector<std::pair<int, int>>& requests, std::vector<Path>& paths) {
+    paths.resize(requests.size());
+
+    getWorkerPool().parallelFor(requests.size(), [&](int i, int worker) {
+        findPath(requests[i].first, requests[i].second, paths[i], workerContexts[worker]);
+    });
+}
+
+void Graph::setQueueType(SearchContext::QueueType type) {
+    queueType = type;
+    searchContext.setQueueType(type);
+    reverseContext.setQueueType(type);
+    for (SearchContext& context : workerContexts) {
+        context.setQueueType(type);
+    }
+}
+
+float Graph::heuristic(int node, int goal) const {
+    if (useLandmarks && !landmarks.empty()) {
+        return landmarks.lowerBound(node, goal);
+    }
+    if (node < 0 || node >= vertices || goal < 0 || goal >= vertices) return 0;
+
+    const sf::Vector2f& a = vertexPositions[node].position;
+    const sf::Vector2f& b = vertexPositions[goal].position;
+    switch (heuristicType) {
+        case MANHATTAN: return manhattanHeuristic(a, b);
+        case OCTILE: return octileHeuristic(a, b);
+        case SQUARED_EUCLIDEAN: return squaredEuclideanHeuristic(a, b);
+        case CUSTOM: return heuristicFunc(a, b);
+        default: return euclideanHeuristic(a, b);
+    }
 }
 
 float Graph::manhattanHeuristic(const sf::Vector2f& a, const sf::Vector2f& b) {
@@ -376,7 +1033,117 @@ float Graph::squaredEuclideanHeuristic(const sf::Vector2f& a, const sf::Vector2f
     return std::pow(a.x - b.x, 2) + std::pow(a.y - b.y, 2);
 }
 
+float Graph::octileHeuristic(const sf::Vector2f& a, const sf::Vector2f& b) {
+    float dx = std::abs(a.x - b.x);
+    float dy = std::abs(a.y - b.y);
+    return std::max(dx, dy) + (std::sqrt(2.0f) - 1) * std::min(dx, dy);
+}
+
 void Graph::setHeuristic(std::function<float(const sf::Vector2f&, const sf::Vector2f&)> func) {
     heuristicFunc = func;
+    heuristicType = CUSTOM;
+
+    // A plain pointer to one of the static heuristics can use its inlined search instead
+    using HeuristicPointer = float (*)(const sf::Vector2f&, const sf::Vector2f&);
+    const HeuristicPointer* pointer = func.target<HeuristicPointer>();
+    if (!pointer) return;
+
+    if (*pointer == &Graph::euclideanHeuristic) heuristicType = EUCLIDEAN;
+    else if (*pointer == &Graph::manhattanHeuristic) heuristicType = MANHATTAN;
+    else if (*pointer == &Graph::octileHeuristic) heuristicType = OCTILE;
+    else if (*pointer == &Graph::squaredEuclideanHeuristic) heuristicType = SQUARED_EUCLIDEAN;
 }
 
+void Graph::setHeuristic(HeuristicType type) {
+    heuristicType = type;
+}
+
+Graph::HeuristicType Graph::getHeuristicType() const {
+    return heuristicType;
+}
+
+bool Graph::buildNextHopTable() {
+    WorkerPool& pool = getWorkerPool();
+    return nextHops.build(*this, pool, workerContexts);
+}
+
+void Graph::refreshNextHopTable() {
+    if (nextHops.empty()) return;
+
+    WorkerPool& pool = getWorkerPool();
+    nextHops.refresh(*this, pool, workerContexts);
+}
+
+void Graph::clearNextHopTable() {
+    nextHops.clear();
+}
+
+uint64_t Graph::getEdgeChecksum() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](uint32_t value) {
+        for (int byte = 0; byte < 4; byte++) {
+            hash ^= (value >> (byte * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    // Degrees keep the same targets split differently between vertices from colliding
+    for (int u = 0; u < vertices; u++) {
+        uint32_t degree = 0;
+        forEachNeighbor(u, [&](int v, float weight) {
+            if (v < 0 || v >= vertices) return;
+            uint32_t bits;
+            std::memcpy(&bits, &weight, sizeof(bits));
+            mix((uint32_t) v);
+            mix(bits);
+            degree++;
+        });
+        mix(degree);
+    }
+    return hash;
+}
+
+const NextHopTable& Graph::getNextHopTable() const {
+    return nextHops;
+}
+
+int Graph::lookupNextHop(int start, int end) {
+    if (start < 0 || start >= vertices || end < 0 || end >= vertices) return -1;
+
+    // Rows dirtied by edge changes are recomputed the first time they are read
+    nextHops.refreshRow(*this, end, searchContext);
+    return nextHops.getNextHop(start, end);
+}
+
+void Graph::buildLandmarks(int count) {
+    landmarks.build(*this, count, isDirected);
+    useLandmarks = true;
+}
+
+bool Graph::prepareLandmarks(std::string landmarkPath, int count) {
+    if (loadLandmarks(landmarkPath)) {
+        return true;
+    }
+    buildLandmarks(count);
+    return saveLandmarks(landmarkPath);
+}
+
+bool Graph::saveLandmarks(std::string landmarkPath) {
+    return landmarks.save(landmarkPath);
+}
+
+bool Graph::loadLandmarks(std::string landmarkPath) {
+    if (!landmarks.load(landmarkPath, *this, isDirected)) {
+        return false;
+    }
+    useLandmarks = true;
+    return true;
+}
+
+void Graph::setLandmarkHeuristic(bool enabled) {
+    useLandmarks = enabled;
+}
+
+bool Graph::hasLandmarks() const {
+    return !landmarks.empty();
+}
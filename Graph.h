@@ -5,13 +5,26 @@
 #include <iostream>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <list>
 #include <cstdlib> 
+#include <cstdint>
 #include <queue>
 #include <fstream>
 #include <sstream>
 #include <cmath>
 #include <functional>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include "SearchContext.h"
+#include "PathCache.h"
+#include "LandmarkTable.h"
+#include "NextHopTable.h"
+#include "WorkerPool.h"
+#include "VertexGrid.h"
+#include "GraphFile.h"
+#include "FlowField.h"
 
 // Define a Vertex structure
 struct Vertex {
@@ -21,14 +34,174 @@ struct Vertex {
 
 // Graph class
 class Graph {
+public:
+    // Built-in heuristics astar can inline. CUSTOM calls the function given to setHeuristic
+    enum HeuristicType {
+        EUCLIDEAN,
+        MANHATTAN,
+        OCTILE,
+        SQUARED_EUCLIDEAN,
+        CUSTOM
+    };
+
 private:
     int vertices;
     bool isDirected;
     std::unordered_map<int, std::list<std::pair<int, float>>> adjList; // Adjacency list (vertex -> (neighbor, weight))
-    std::unordered_map<int, Vertex> vertexPositions; // Store vertex positions
+    std::vector<Vertex> vertexPositions; // Store vertex positions, indexed by dense vertex id
+    VertexGrid vertexGrid; // Spatial index over the vertices that have not been removed
+
+    // Frozen CSR adjacency, built by finalize(). Edges of u live in [csrOffsets[u], csrOffsets[u + 1])
+    bool finalized;
+    std::vector<int> csrOffsets;
+    std::vector<int> csrTargets;
+    std::vector<float> csrWeights;
+
+    // The CSR arrays searches read: the vectors above, or the sections of a mapped binary file
+    const int* offsetData;
+    const int* targetData;
+    const float* weightData;
+
+    // Binary graph mapped by loadBinary(); kept open while the graph stays finalized
+    std::unique_ptr<GraphFile> graphFile;
 
     std::function<float(const sf::Vector2f&, const sf::Vector2f&)> heuristicFunc;
 
+    // Which positional heuristic searchAstar instantiates; heuristicFunc is only called for CUSTOM
+    HeuristicType heuristicType;
+
+    // ALT landmark distances; when enabled they replace heuristicFunc
+    LandmarkTable landmarks;
+    bool useLandmarks;
+
+    // All-pairs first steps; when built they answer the single-threaded dijkstra/astar overloads
+    NextHopTable nextHops;
+
+    // Scratch space for the single-threaded dijkstra/astar overloads
+    SearchContext searchContext;
+
+    // Backward half of the single-threaded bidirectional overloads
+    SearchContext reverseContext;
+
+    // Open list used by searchContext and the batchQuery worker contexts
+    SearchContext::QueueType queueType;
+
+    // Recently requested full paths, cleared whenever edges or vertices are removed or added
+    PathCache pathCache;
+
+    // Recently requested flow fields, cleared alongside the path cache
+    FlowFieldCache flowFields;
+
+    // Threads for batchQuery, started on first use, and one search context per worker
+    std::unique_ptr<WorkerPool> workerPool;
+    int workerCount;
+    std::vector<SearchContext> workerContexts;
+
+    WorkerPool& getWorkerPool();
+
+    // Callbacks told about every edge mutation, keyed by the id addEdgeListener returned
+    std::map<int, std::function<void(int, int)>> edgeListeners;
+    int nextListenerId;
+
+    void notifyEdgeChanged(int u, int v);
+
+    // Callbacks given the old-to-new ids whenever compact() renumbers the vertices
+    std::map<int, std::function<void(const std::vector<int>&)>> remapListeners;
+
+    // Tombstones of removed vertices, indexed by id. Only grown once a vertex is removed
+    std::vector<unsigned char> removedVertices;
+    int removedCount;
+    // Number of compact() calls that renumbered vertices, so id holders can tell their ids went stale
+    int compactions;
+
+    // Mutable mode: directed graphs also keep the sources of the edges into each vertex, so
+    // removeVertex only visits its neighbors. Undirected adjacency already holds both directions
+    bool trackIncoming;
+    bool incomingStale;
+    std::unordered_map<int, std::vector<int>> incoming;
+
+    // Rebuild incoming from adjList if it was dropped since the last time
+    void prepareIncoming();
+
+    // Forget one source of the edges into target
+    void eraseIncoming(int target, int source);
+
+    // First step from the next-hop table, recomputing the goal's row if an edge change dirtied it
+    int lookupNextHop(int start, int goal);
+
+    // Heuristic functors for searchAstar: the estimate from vertex v to the goal they were made for.
+    // Each is a concrete type, so every instantiation of the search inlines its own estimate
+    struct PositionHeuristic {
+        const Vertex* positions;
+        sf::Vector2f goal;
+    };
+    struct EuclideanEstimate : PositionHeuristic {
+        float operator()(int v) const {
+            sf::Vector2f d = positions[v].position - goal;
+            return std::sqrt(d.x * d.x + d.y * d.y);
+        }
+    };
+    struct ManhattanEstimate : PositionHeuristic {
+        float operator()(int v) const {
+            sf::Vector2f d = positions[v].position - goal;
+            return std::abs(d.x) + std::abs(d.y);
+        }
+    };
+    struct OctileEstimate : PositionHeuristic {
+        float operator()(int v) const {
+            sf::Vector2f d = positions[v].position - goal;
+            float dx = std::abs(d.x), dy = std::abs(d.y);
+            return std::max(dx, dy) + (std::sqrt(2.0f) - 1) * std::min(dx, dy);
+        }
+    };
+    struct SquaredEuclideanEstimate : PositionHeuristic {
+        float operator()(int v) const {
+            sf::Vector2f d = positions[v].position - goal;
+            return d.x * d.x + d.y * d.y;
+        }
+    };
+    struct CustomEstimate : PositionHeuristic {
+        const std::function<float(const sf::Vector2f&, const sf::Vector2f&)>* func;
+        float operator()(int v) const {
+            return (*func)(positions[v].position, goal);
+        }
+    };
+    struct ZeroEstimate {
+        float operator()(int) const {
+            return 0;
+        }
+    };
+
+    // Call search(toEnd, toStart) with the active heuristic's functors towards end and towards start
+    template <typename Search>
+    bool withHeuristic(int start, int end, Search&& search) const;
+
+    // Run the searches into context. Return true if goal was reached
+    bool searchDijkstra(int start, int goal, SearchContext& context) const;
+    bool searchAstar(int start, int goal, SearchContext& context) const;
+
+    // The A* loop for one heuristic. searchAstar picks the instantiation once per query
+    template <typename Heuristic>
+    bool searchAstar(int start, int goal, SearchContext& context, const Heuristic& estimate) const;
+
+    // Search forward from start and backward from goal until the two meet on a shortest route.
+    // meeting is on that route: forward's previous links lead from it to start, backward's to goal
+    bool searchBidirectional(int start, int goal, SearchContext& forward, SearchContext& backward, bool useHeuristic, int& meeting) const;
+
+    template <typename Heuristic>
+    bool searchBidirectional(int start, int goal, SearchContext& forward, SearchContext& backward,
+                             const Heuristic& toGoal, const Heuristic& toStart, int& meeting) const;
+
+    // First step out of start on the route through meeting
+    int firstStep(int start, int meeting, const SearchContext& forward, const SearchContext& backward) const;
+
+    // Walk the previous links of a finished search back to the move out of start
+    int firstStep(int start, int goal, const SearchContext& context) const;
+
+    // Drop the CSR arrays so the graph can be mutated again through adjList. A mapped graph
+    // copies its edges into adjList first
+    void thaw();
+
 
 public:
     // Constructor
@@ -42,48 +215,224 @@ public:
 
     void readEdges(std::string edgePath);
 
+    // Freeze the current adjacency into contiguous CSR arrays. Call after readVertices/readEdges;
+    // any later mutation thaws the graph back to the adjacency list until finalize() is called again
+    void finalize();
+
+    bool isFinalized();
+
+    // Write the finalized CSR arrays as a binary graph file, finalizing first if needed. Removed
+    // vertices are compacted away first, so ids held across the call need remapping as for compact()
+    bool saveBinary(std::string binaryPath);
+
+    // Replace this graph with a file written by saveBinary. The edges are mapped, not read,
+    // and the graph loads finalized. Returns false and leaves the graph untouched on failure
+    bool loadBinary(std::string binaryPath);
+
     // Generate random positions for vertices
     void generateRandomPositions(int count);
 
-    int getVertexCount();
+    // Replace this graph with count vertices at seeded uniform positions over a worldSize square, each
+    // linked to its k nearest neighbors by edges as long as the distance between them. Runs in near-linear
+    // time through the vertex grid, the same seed always gives the same graph, and the graph is left finalized
+    void generateSpatialGraph(int count, int k, unsigned seed, float worldSize = 1000);
+
+    int getVertexCount() const;
 
-    Vertex getVertex(int idx);
+    // Number of adjacency entries; undirected edges count once per direction
+    long getEdgeCount() const;
+
+    // FNV-1a hash of the CSR targets and weights finalize() produces, the same whether or not the
+    // graph is finalized. Files derived from the graph save it to tell reweighted edges apart
+    uint64_t getEdgeChecksum() const;
+
+    Vertex getVertex(int idx) const;
 
     void addVertex(float x, float y);
 
     // Add edge with weight
     void addEdge(int u, int v, float weight = 1.0f);
 
+    // Drop every edge into and out of u and tombstone it. The id stays taken until compact()
     void removeVertex(int u);
 
+    bool isRemoved(int v) const {
+        return v >= 0 && v < (int) removedVertices.size() && removedVertices[v];
+    }
+
+    int getRemovedVertexCount() const;
+
+    // Keep incoming edge lists so removeVertex costs O(degree) on directed graphs too. Undirected
+    // graphs get that without the extra lists. Built on the first removal after enabling
+    void setMutable(bool enabled);
+
+    bool isMutable() const;
+
+    // Renumber the live vertices densely, in their current order, and drop the tombstones. Cached
+    // paths, flow fields, landmarks and the next-hop table are cleared since their ids change.
+    // Returns the new id of every old id, -1 for removed ones, for callers holding vertex ids.
+    // Remap listeners get the same ids: a DStarLite renumbers its start and goal and plans again.
+    // A PathRequest made before the call is cancelled at its next begin() or step(), since its
+    // start and goal no longer name the same vertices; request again with the new ids
+    std::vector<int> compact();
+
+    // Number of compact() calls that renumbered the vertices so far
+    int getCompactionCount() const;
+
     // Remove edge between two vertices
     void removeEdge(int u, int v);
 
+    bool isDirectedGraph() const;
+
+    // Call listener(u, v) after the edges from u to v are added or removed, once per direction
+    // that changed. loadBinary replaces the whole graph without notifying. Returns an id for removeEdgeListener
+    int addEdgeListener(std::function<void(int, int)> listener);
+
+    void removeEdgeListener(int id);
+
+    // Call listener(newIds) after compact() renumbers the vertices, with the same ids it returns.
+    // Returns an id for removeRemapListener
+    int addRemapListener(std::function<void(const std::vector<int>&)> listener);
+
+    void removeRemapListener(int id);
+
     // Draw the graph using SFML
     void drawGraph(sf::RenderWindow &window);
 
     // Get position of a vertex
-    sf::Vector2f getPosition(int v);
+    sf::Vector2f getPosition(int v) const;
 
     // Get the closest vertex
     Vertex getClosestVertex(int x, int y);
 
+    // Ids of up to k vertices closest to (x, y), closest first
+    std::vector<int> getClosestVertices(float x, float y, int k) const;
+
     int calculateDistance(Vertex u, Vertex v);
 
     int dijkstra(int start, int goal);
 
+    // Same search on caller-owned scratch space. Separate contexts may search concurrently
+    int dijkstra(int start, int goal, SearchContext& context) const;
+
     int astar(int start, int goal);
 
-    float heuristic(int start, int goal);
+    int astar(int start, int goal, SearchContext& context) const;
+
+    // Fill path with the whole A* route from start to goal. Returns false if goal is unreachable
+    bool findPath(int start, int goal, Path& path, SearchContext& context) const;
+
+    // Search from both ends at once and meet in the middle, which explores far less of a large graph
+    // on long queries. Same distance as dijkstra/astar, though ties may pick another first step.
+    // bidirectionalAstar needs a consistent heuristic. Directed graphs fall back to the one-way search
+    int bidirectionalDijkstra(int start, int goal);
+
+    int bidirectionalDijkstra(int start, int goal, SearchContext& forward, SearchContext& backward) const;
+
+    int bidirectionalAstar(int start, int goal);
+
+    int bidirectionalAstar(int start, int goal, SearchContext& forward, SearchContext& backward) const;
+
+    // Fill path with the whole bidirectional A* route. Returns false if goal is unreachable
+    bool findPathBidirectional(int start, int goal, Path& path, SearchContext& forward, SearchContext& backward) const;
+
+    // Whole A* route served from the LRU path cache; the vertex list is empty if goal is unreachable
+    std::shared_ptr<const Path> getPath(int start, int goal);
+
+    void setPathCacheCapacity(int capacity);
+
+    const PathCache& getPathCache() const;
+
+    // Distance and next hop towards goal from every vertex, from one reverse Dijkstra shared by
+    // every agent heading there. Cached until edges or vertices are removed or added
+    std::shared_ptr<const FlowField> getFlowField(int goal);
+
+    void setFlowFieldCapacity(int capacity);
+
+    const FlowFieldCache& getFlowFieldCache() const;
+
+    // Threads used by batchQuery, including the caller; 0 uses every hardware thread
+    void setWorkerCount(int count);
+
+    // Run astar for every (start, goal) across the worker pool and return the first steps in request order.
+    // The graph must not be mutated until the call returns. Bypasses the path cache
+    std::vector<int> batchQuery(const std::vector<std::pair<int, int>>& requests);
+
+    // Same, filling paths[i] with the whole route of requests[i]
+    void batchQuery(const std::vector<std::pair<int, int>>& requests, std::vector<Path>& paths);
+
+    // Pick the open list for this graph's own searches. RADIX_HEAP is fastest when keys never drop below
+    // the last one popped: dijkstra, and astar with a consistent heuristic such as landmarks. With an
+    // inconsistent one (MANHATTAN off a 4-connected lattice, SQUARED_EUCLIDEAN, some CUSTOM) a search
+    // falls back to the binary heap once a key drops, so route lengths match BINARY_HEAP
+    void setQueueType(SearchContext::QueueType type);
+
+    float heuristic(int start, int goal) const;
 
     static float manhattanHeuristic(const sf::Vector2f& a, const sf::Vector2f& b);
 
     static float euclideanHeuristic(const sf::Vector2f& a, const sf::Vector2f& b);
 
+    // Not admissible: A* may return longer routes with it
     static float squaredEuclideanHeuristic(const sf::Vector2f& a, const sf::Vector2f& b);
 
+    // Diagonal distance for 8-connected grids; exceeds the straight line, so only admissible
+    // when edges are axis-aligned or diagonal moves
+    static float octileHeuristic(const sf::Vector2f& a, const sf::Vector2f& b);
+
+    // Any function works; the static heuristics above are recognized and run inlined
     void setHeuristic(std::function<float(const sf::Vector2f&, const sf::Vector2f&)> func);
 
+    void setHeuristic(HeuristicType type);
+
+    HeuristicType getHeuristicType() const;
+
+    // Precompute the first step and distance between every pair of vertices, one Dijkstra per source
+    // across the worker pool, and answer dijkstra(start, goal)/astar(start, goal) from it. Edge changes
+    // dirty only the rows they affect; vertex additions drop the table. Returns false if the graph
+    // has more than NextHopTable::MAX_VERTICES vertices
+    bool buildNextHopTable();
+
+    // Recompute every dirty row across the worker pool now instead of on their next lookup
+    void refreshNextHopTable();
+
+    void clearNextHopTable();
+
+    const NextHopTable& getNextHopTable() const;
+
+    // Precompute count ALT landmarks with one full Dijkstra each and switch astar to them
+    void buildLandmarks(int count);
+
+    // Load landmarks saved next to the graph csvs, or build and save them if the file is missing or stale
+    bool prepareLandmarks(std::string landmarkPath, int count);
+
+    bool saveLandmarks(std::string landmarkPath);
+
+    bool loadLandmarks(std::string landmarkPath);
+
+    // Toggle between the ALT bounds and the positional heuristic. Adding edges or vertices drops the landmarks
+    void setLandmarkHeuristic(bool enabled);
+
+    bool hasLandmarks() const;
+
+    // Visit every (neighbor, weight) pair of u using whichever adjacency backend is active
+    template <typename Visitor>
+    void forEachNeighbor(int u, Visitor&& visit) const {
+        if (finalized) {
+            if (u < 0 || u >= vertices) return;
+            for (int e = offsetData[u]; e < offsetData[u + 1]; e++) {
+                visit(targetData[e], weightData[e]);
+            }
+            return;
+        }
+
+        auto it = adjList.find(u);
+        if (it == adjList.end()) return;
+        for (const auto& [neighbor, weight] : it->second) {
+            visit(neighbor, weight);
+        }
+    }
+
 };
 
 
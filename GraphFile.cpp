@@ -0,0 +1,153 @@
+#include "GraphFile.h"
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = {'S', 'F', 'G', 'G'};
+
+GraphFile::GraphFile() : data(nullptr), length(0) {
+}
+
+GraphFile::~GraphFile() {
+    close();
+}
+
+bool GraphFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1 || (size_t) info.st_size < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    data = static_cast<const char*>(mapping);
+    length = info.st_size;
+
+    const Header& head = header();
+    if (std::memcmp(head.magic, MAGIC, sizeof(MAGIC)) != 0 || head.version != VERSION) {
+        std::cerr << "Not a version " << VERSION << " graph file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Offsets are int32, so larger counts cannot be a file write produced, and would overflow below
+    if (head.vertexCount > (std::uint32_t) INT_MAX || head.edgeCount > (std::uint64_t) INT_MAX) {
+        std::cerr << "Corrupt graph file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Every section must be present, and the offsets must agree with the edge count
+    size_t expected = sizeof(Header) + sizeof(float) * 2 * (size_t) head.vertexCount + sizeof(int) * ((size_t) head.vertexCount + 1)
+                    + (sizeof(int) + sizeof(float)) * (size_t) head.edgeCount;
+    if (length != expected || getOffsets()[0] != 0 || (std::uint64_t) getOffsets()[head.vertexCount] != head.edgeCount) {
+        std::cerr << "Truncated or corrupt graph file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    // Searches index straight into the mapped arrays, so one pass makes sure every slice lies
+    // within the targets and every target is a vertex. Cheap next to the page faults it takes
+    const int* offsets = getOffsets();
+    const int* targets = getTargets();
+    int vertexCount = head.vertexCount;
+    for (int u = 0; u < vertexCount; u++) {
+        if (offsets[u + 1] < offsets[u]) {
+            std::cerr << "Corrupt graph file, offsets go backwards: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    for (std::uint64_t e = 0; e < head.edgeCount; e++) {
+        if (targets[e] < 0 || targets[e] >= vertexCount) {
+            std::cerr << "Corrupt graph file, edge target out of range: " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void GraphFile::close() {
+    if (data) {
+        munmap(const_cast<char*>(data), length);
+    }
+    data = nullptr;
+    length = 0;
+}
+
+bool GraphFile::write(const std::string& path, bool directed, int vertexCount, const std::vector<float>& positions,
+                      const int* offsets, const int* targets, const float* weights) {
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    Header head;
+    std::memcpy(head.magic, MAGIC, sizeof(MAGIC));
+    head.version = VERSION;
+    head.directed = directed ? 1 : 0;
+    head.vertexCount = vertexCount;
+    head.edgeCount = offsets[vertexCount];
+
+    file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    file.write(reinterpret_cast<const char*>(positions.data()), sizeof(float) * 2 * (size_t) vertexCount);
+    file.write(reinterpret_cast<const char*>(offsets), sizeof(int) * ((size_t) vertexCount + 1));
+    file.write(reinterpret_cast<const char*>(targets), sizeof(int) * head.edgeCount);
+    file.write(reinterpret_cast<const char*>(weights), sizeof(float) * head.edgeCount);
+
+    return file.good();
+}
+
+bool GraphFile::isOpen() const {
+    return data != nullptr;
+}
+
+bool GraphFile::isDirected() const {
+    return header().directed != 0;
+}
+
+int GraphFile::getVertexCount() const {
+    return header().vertexCount;
+}
+
+long GraphFile::getEdgeCount() const {
+    return header().edgeCount;
+}
+
+const float* GraphFile::getPositions() const {
+    return reinterpret_cast<const float*>(data + sizeof(Header));
+}
+
+const int* GraphFile::getOffsets() const {
+    return reinterpret_cast<const int*>(getPositions() + 2 * (size_t) getVertexCount());
+}
+
+const int* GraphFile::getTargets() const {
+    return getOffsets() + getVertexCount() + 1;
+}
+
+const float* GraphFile::getWeights() const {
+    return reinterpret_cast<const float*>(getTargets() + getEdgeCount());
+}
@@ -0,0 +1,96 @@
+#ifndef GRAPH_FILE_H
+#define GRAPH_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Read-only memory mapping of a binary graph file.
+ *
+ * The file is a fixed header followed by the finalized CSR arrays exactly as Graph
+ * searches read them, so loading is one mmap, size checks and one validation pass, with no parsing:
+ *
+ *     header     magic "SFGG", version, directed, vertex count, edge count
+ *     positions  float[2 * V]  x, y of every vertex
+ *     offsets    int32[V + 1]  edges of u are [offsets[u], offsets[u + 1])
+ *     targets    int32[E]
+ *     weights    float[E]
+ *
+ * Values are stored in native byte order; a file written on a machine of the
+ * other endianness is rejected by the magic check.
+ */
+class GraphFile {
+private:
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t directed;
+        std::uint32_t vertexCount;
+        std::uint64_t edgeCount;
+    };
+
+    /** Start of the mapping, nullptr if nothing is open */
+    const char* data;
+    size_t length;
+
+    const Header& header() const {
+        return *reinterpret_cast<const Header*>(data);
+    }
+
+public:
+
+    /** Bumped whenever the layout changes, so older files are rejected instead of misread */
+    static const std::uint32_t VERSION = 1;
+
+    GraphFile();
+
+    ~GraphFile();
+
+    GraphFile(const GraphFile&) = delete;
+    GraphFile& operator=(const GraphFile&) = delete;
+
+    /**
+     * Map a file written by write and check that its header matches its size, its offsets
+     * never decrease and every edge target is a vertex
+     *
+     * @return if the file was mapped
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Unmap the file. Pointers handed out before become invalid
+     */
+    void close();
+
+    /**
+     * Write finalized CSR arrays in the binary layout
+     *
+     * @param positions Interleaved x, y of every vertex
+     * @param offsets vertexCount + 1 CSR offsets
+     * @param targets offsets[vertexCount] neighbor ids
+     * @param weights offsets[vertexCount] edge weights
+     * @return if the file was written
+     */
+    static bool write(const std::string& path, bool directed, int vertexCount, const std::vector<float>& positions,
+                      const int* offsets, const int* targets, const float* weights);
+
+    bool isOpen() const;
+
+    bool isDirected() const;
+
+    int getVertexCount() const;
+
+    long getEdgeCount() const;
+
+    const float* getPositions() const;
+
+    const int* getOffsets() const;
+
+    const int* getTargets() const;
+
+    const float* getWeights() const;
+};
+
+#endif
@@ -0,0 +1,260 @@
+#include "HierarchicalGraph.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <tuple>
+
+HierarchicalGraph::HierarchicalGraph(Graph& graph, const OccupancyGrid& grid, int clusterSize, int maxTransitions)
+: graph(graph), grid(grid), clusterSize(std::max(clusterSize, 1)), maxTransitions(std::max(maxTransitions, 1)), clusterCols(0), clusterCount(0) {
+    build();
+}
+
+void HierarchicalGraph::build() {
+
+    int vertexCount = graph.getVertexCount();
+
+    int clusterRows = (grid.getRows() + clusterSize - 1) / clusterSize;
+    clusterCols = (grid.getCols() + clusterSize - 1) / clusterSize;
+    clusterCount = clusterRows * clusterCols;
+
+    // Step 1: Assign every vertex to the cluster of the tile it sits in
+    clusterOf.assign(vertexCount, 0);
+    for (int v = 0; v < vertexCount; v++) {
+        int cell = grid.cellAt(graph.getPosition(v));
+        int row = cell / grid.getCols();
+        int col = cell % grid.getCols();
+        clusterOf[v] = (row / clusterSize) * clusterCols + col / clusterSize;
+    }
+
+    // Step 2: Split edges into intra-cluster edges and crossing edges
+    localOut.assign(vertexCount, {});
+    localIn.assign(vertexCount, {});
+    abstractEdges.assign(vertexCount, {});
+    std::vector<std::tuple<int, int, float>> crossing;
+
+    // Union-find over intra-cluster edges, so crossings can be grouped by the pieces they connect
+    std::vector<int> component(vertexCount);
+    std::iota(component.begin(), component.end(), 0);
+    auto findRoot = [&](int v) {
+        while (component[v] != v) {
+            component[v] = component[component[v]];
+            v = component[v];
+        }
+        return v;
+    };
+
+    for (int u = 0; u < vertexCount; u++) {
+        graph.forEachNeighbor(u, [&](int v, float weight) {
+            if (clusterOf[u] == clusterOf[v]) {
+                localOut[u].push_back({v, weight});
+                localIn[v].push_back({u, weight});
+                component[findRoot(u)] = findRoot(v);
+            }
+            else {
+                crossing.emplace_back(u, v, weight);
+            }
+        });
+    }
+
+    // Step 3: Keep a few evenly spread transitions per group of parallel crossing edges
+    std::map<std::pair<int, int>, std::vector<std::tuple<int, int, float>>> groups;
+    for (const auto& edge : crossing) {
+        groups[{findRoot(std::get<0>(edge)), findRoot(std::get<1>(edge))}].push_back(edge);
+    }
+
+    std::vector<bool> isEntrance(vertexCount, false);
+    for (auto& [key, edges] : groups) {
+        int u = std::get<0>(edges.front());
+        int v = std::get<1>(edges.front());
+        bool sameClusterRow = clusterOf[u] / clusterCols == clusterOf[v] / clusterCols;
+
+        // Order along the shared border: by y for side-by-side clusters, by x otherwise
+        std::sort(edges.begin(), edges.end(), [&](const auto& a, const auto& b) {
+            sf::Vector2f posA = graph.getPosition(std::get<0>(a));
+            sf::Vector2f posB = graph.getPosition(std::get<0>(b));
+            return sameClusterRow ? posA.y < posB.y : posA.x < posB.x;
+        });
+
+        int count = edges.size();
+        int keep = std::min(count, maxTransitions);
+        for (int i = 0; i < keep; i++) {
+            int pick = keep == 1 ? count / 2 : i * (count - 1) / (keep - 1);
+            auto [from, to, weight] = edges[pick];
+            abstractEdges[from].push_back({to, weight});
+            isEntrance[from] = true;
+            isEntrance[to] = true;
+        }
+    }
+
+    entrances.assign(clusterCount, {});
+    for (int v = 0; v < vertexCount; v++) {
+        if (isEntrance[v]) entrances[clusterOf[v]].push_back(v);
+    }
+
+    // Step 4: Precompute distances between entrances of the same cluster
+    for (int c = 0; c < clusterCount; c++) {
+        for (int from : entrances[c]) {
+            localSearch(from, false, -1);
+            for (int to : entrances[c]) {
+                float distance = localContext.getDistance(to);
+                if (to != from && distance < std::numeric_limits<float>::infinity()) {
+                    abstractEdges[from].push_back({to, distance});
+                }
+            }
+        }
+    }
+}
+
+void HierarchicalGraph::localSearch(int source, bool reverse, int target) {
+
+    const auto& edges = reverse ? localIn : localOut;
+
+    localContext.begin(graph.getVertexCount());
+    localContext.relax(source, 0, 0, -1);
+
+    while (!localContext.empty()) {
+        auto entry = localContext.pop();
+        int current = entry.second;
+
+        if (current == target) break;
+        if (localContext.isStale(entry)) continue;
+
+        float distance = localContext.getDistance(current);
+        for (const auto& [neighbor, weight] : edges[current]) {
+            float newDistance = distance + weight;
+            if (newDistance < localContext.getDistance(neighbor)) {
+                localContext.relax(neighbor, newDistance, newDistance, current);
+            }
+        }
+    }
+}
+
+bool HierarchicalGraph::abstractSearch(int start, int goal) {
+
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    // Link the start to the entrances of its cluster (and to the goal if they share one)
+    localSearch(start, false, -1);
+    startLinks.clear();
+    for (int entrance : entrances[clusterOf[start]]) {
+        float distance = localContext.getDistance(entrance);
+        if (entrance != start && distance < infinity) startLinks.push_back({entrance, distance});
+    }
+    if (clusterOf[goal] == clusterOf[start] && localContext.getDistance(goal) < infinity) {
+        startLinks.push_back({goal, localContext.getDistance(goal)});
+    }
+
+    // Link the entrances of the goal's cluster to the goal
+    localSearch(goal, true, -1);
+    goalLinks.clear();
+    for (int entrance : entrances[clusterOf[goal]]) {
+        float distance = localContext.getDistance(entrance);
+        if (entrance != goal && distance < infinity) goalLinks[entrance] = distance;
+    }
+
+    // A* over the entrances
+    abstractContext.begin(graph.getVertexCount());
+    abstractContext.relax(start, 0, graph.heuristic(start, goal), -1);
+
+    auto relax = [&](int from, int to, float weight) {
+        float tentative = abstractContext.getDistance(from) + weight;
+        if (tentative < abstractContext.getDistance(to)) {
+            abstractContext.relax(to, tentative, tentative + graph.heuristic(to, goal), from);
+        }
+    };
+
+    while (!abstractContext.empty()) {
+        auto entry = abstractContext.pop();
+        int current = entry.second;
+
+        if (current == goal) break;
+        if (abstractContext.isStale(entry)) continue;
+
+        if (current == start) {
+            for (const auto& [to, weight] : startLinks) relax(current, to, weight);
+        }
+        for (const auto& [to, weight] : abstractEdges[current]) relax(current, to, weight);
+
+        auto link = goalLinks.find(current);
+        if (link != goalLinks.end()) relax(current, goal, link->second);
+    }
+
+    if (abstractContext.getDistance(goal) == infinity) return false;
+
+    abstractPath.clear();
+    for (int current = goal; current != -1; current = abstractContext.getPrevious(current)) {
+        abstractPath.push_back(current);
+    }
+    std::reverse(abstractPath.begin(), abstractPath.end());
+    return true;
+}
+
+void HierarchicalGraph::refineSegment(int from, int to, std::vector<int>& path) {
+
+    // Transitions are single concrete edges
+    if (clusterOf[from] != clusterOf[to]) {
+        path.push_back(to);
+        return;
+    }
+
+    // Intra-cluster hops are re-searched inside the cluster
+    localSearch(from, false, to);
+    size_t segmentStart = path.size();
+    for (int current = to; current != from && current != -1; current = localContext.getPrevious(current)) {
+        path.push_back(current);
+    }
+    std::reverse(path.begin() + segmentStart, path.end());
+}
+
+bool HierarchicalGraph::findPathPrefix(int start, int goal, int steps, std::vector<int>& prefix) {
+
+    prefix.clear();
+    int vertexCount = graph.getVertexCount();
+    if (start < 0 || start >= vertexCount || goal < 0 || goal >= vertexCount) return false;
+
+    prefix.push_back(start);
+    if (start == goal) return true;
+
+    if (!abstractSearch(start, goal)) {
+        // Pruned transitions can disconnect directed graphs, so fall back to a flat search
+        Path path;
+        if (!graph.findPath(start, goal, path, localContext)) {
+            prefix.clear();
+            return false;
+        }
+        prefix = path.vertices;
+        return true;
+    }
+
+    // Only refine until the caller has the moves it asked for
+    for (size_t i = 0; i + 1 < abstractPath.size(); i++) {
+        if (steps > 0 && (int) prefix.size() > steps) break;
+        refineSegment(abstractPath[i], abstractPath[i + 1], prefix);
+    }
+
+    if (steps > 0 && (int) prefix.size() > steps + 1) {
+        prefix.resize(steps + 1);
+    }
+    return true;
+}
+
+int HierarchicalGraph::astar(int start, int goal) {
+    if (!findPathPrefix(start, goal, 1, stepPrefix) || stepPrefix.size() < 2) return -1;
+    return stepPrefix[1];
+}
+
+int HierarchicalGraph::getCluster(int v) const {
+    return clusterOf[v];
+}
+
+int HierarchicalGraph::getClusterCount() const {
+    return clusterCount;
+}
+
+int HierarchicalGraph::getEntranceCount() const {
+    int count = 0;
+    for (const auto& clusterEntrances : entrances) {
+        count += clusterEntrances.size();
+    }
+    return count;
+}
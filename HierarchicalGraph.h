@@ -0,0 +1,111 @@
+#ifndef HIERARCHICAL_GRAPH_H
+#define HIERARCHICAL_GRAPH_H
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include "Graph.h"
+#include "OccupancyGrid.h"
+#include "SearchContext.h"
+
+/**
+ * Hierarchical pathfinding (HPA*) layer over a Graph.
+ *
+ * Vertices are clustered by the block of OccupancyGrid tiles they sit in. Edges that cross
+ * between clusters become transitions whose endpoints are entrances, and the distances
+ * between entrances of the same cluster are precomputed. A query searches this small
+ * abstract graph first and then refines only as many concrete steps as the caller needs.
+ *
+ * The abstraction is a snapshot of the graph: call build() again after mutating it.
+ */
+class HierarchicalGraph {
+private:
+    /** The concrete graph */
+    Graph& graph;
+    /** The tile grid used to cluster vertices */
+    const OccupancyGrid& grid;
+    /** Width and height of a cluster, in tiles */
+    int clusterSize;
+    /** Transitions kept per group of parallel crossing edges */
+    int maxTransitions;
+    /** Number of cluster columns */
+    int clusterCols;
+    /** Number of clusters */
+    int clusterCount;
+    /** Cluster of every vertex */
+    std::vector<int> clusterOf;
+    /** Entrance vertices of every cluster */
+    std::vector<std::vector<int>> entrances;
+    /** Edges that stay inside a cluster, outgoing and incoming */
+    std::vector<std::vector<std::pair<int, float>>> localOut;
+    std::vector<std::vector<std::pair<int, float>>> localIn;
+    /** Abstract edges out of each entrance: transitions and precomputed intra-cluster distances */
+    std::vector<std::vector<std::pair<int, float>>> abstractEdges;
+    /** Scratch space for cluster-restricted and abstract searches */
+    SearchContext localContext;
+    SearchContext abstractContext;
+    /** Per-query links from the start to its cluster's entrances, and from entrances to the goal */
+    std::vector<std::pair<int, float>> startLinks;
+    std::unordered_map<int, float> goalLinks;
+    /** Per-query abstract route and refined prefix */
+    std::vector<int> abstractPath;
+    std::vector<int> stepPrefix;
+
+    /**
+     * Dijkstra that never leaves the cluster of source
+     *
+     * @param source Vertex to search from
+     * @param reverse Follow incoming instead of outgoing edges
+     * @param target Stop once this vertex is settled, -1 to settle the whole cluster
+     */
+    void localSearch(int source, bool reverse, int target);
+
+    /**
+     * Search the abstract graph with start and goal temporarily linked in
+     */
+    bool abstractSearch(int start, int goal);
+
+    /**
+     * Append the concrete vertices after from on the way to the next abstract node to
+     */
+    void refineSegment(int from, int to, std::vector<int>& path);
+
+public:
+
+    /**
+     * Build the abstraction
+     *
+     * @param graph The concrete graph
+     * @param grid The grid whose tiles define clusters
+     * @param clusterSize Width and height of a cluster, in tiles
+     * @param maxTransitions Transitions kept per group of parallel crossing edges
+     */
+    HierarchicalGraph(Graph& graph, const OccupancyGrid& grid, int clusterSize = 5, int maxTransitions = 2);
+
+    /**
+     * Rebuild clusters, entrances and intra-cluster distances from the current graph
+     */
+    void build();
+
+    /**
+     * Get the first step from start towards goal, -1 if unreachable
+     */
+    int astar(int start, int goal);
+
+    /**
+     * Find the start of a route from start to goal, refining the abstract path lazily
+     *
+     * @param steps Moves to refine, 0 refines the whole route
+     * @param prefix Filled with start followed by at least steps moves (fewer if the goal is closer)
+     * @return if the goal is reachable
+     */
+    bool findPathPrefix(int start, int goal, int steps, std::vector<int>& prefix);
+
+    int getCluster(int v) const;
+
+    int getClusterCount() const;
+
+    int getEntranceCount() const;
+};
+
+#endif
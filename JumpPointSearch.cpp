@@ -0,0 +1,267 @@
+#include "JumpPointSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+JumpPointSearch::JumpPointSearch(const OccupancyGrid& grid)
+: grid(grid), syncedVersion(0), synced(false), rows(0), cols(0), rowWords(0), colWords(0),
+  straightX(1), straightY(1), diagonal(std::sqrt(2.0f)), goal(-1) {
+}
+
+void JumpPointSearch::sync() {
+    if (synced && syncedVersion == grid.getVersion()) return;
+
+    rows = grid.getRows();
+    cols = grid.getCols();
+    straightX = grid.getCellWidth();
+    straightY = grid.getCellHeight();
+    diagonal = std::sqrt(straightX * straightX + straightY * straightY);
+
+    // One spare word before and after every line keeps the scans inside the arrays
+    rowWords = (cols + 63) / 64 + 2;
+    colWords = (rows + 63) / 64 + 2;
+    rowBits.assign((size_t) (rows + 2) * rowWords, 0);
+    colBits.assign((size_t) (cols + 2) * colWords, 0);
+
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (!grid.isOpen(row, col)) continue;
+
+            int bit = col + 64;
+            rowBits[(size_t) (row + 1) * rowWords + (bit >> 6)] |= 1ULL << (bit & 63);
+            bit = row + 64;
+            colBits[(size_t) (col + 1) * colWords + (bit >> 6)] |= 1ULL << (bit & 63);
+        }
+    }
+
+    syncedVersion = grid.getVersion();
+    synced = true;
+}
+
+bool JumpPointSearch::isOpen(int row, int col) const {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return false;
+
+    int bit = col + 64;
+    return (rowBits[(size_t) (row + 1) * rowWords + (bit >> 6)] >> (bit & 63)) & 1;
+}
+
+int JumpPointSearch::scanLine(const std::uint64_t* line, const std::uint64_t* sideA, const std::uint64_t* sideB,
+                              int from, int dir, int goalPosition) {
+
+    // A position stops the scan if it is a wall, or if a side tile opens up right there:
+    // open beside it but closed beside the tile the scan came from, which forces a turn
+    int p = from + 64;
+    int w = p >> 6;
+    int stop;
+
+    if (dir > 0) {
+        std::uint64_t mask = ~0ULL << (p & 63);
+        while (true) {
+            std::uint64_t behindA = (sideA[w] << 1) | (sideA[w - 1] >> 63);
+            std::uint64_t behindB = (sideB[w] << 1) | (sideB[w - 1] >> 63);
+            std::uint64_t stops = (~line[w] | (sideA[w] & ~behindA) | (sideB[w] & ~behindB)) & mask;
+            if (stops) {
+                stop = (w << 6) + __builtin_ctzll(stops) - 64;
+                break;
+            }
+            w++;
+            mask = ~0ULL;
+        }
+    }
+    else {
+        std::uint64_t mask = ~0ULL >> (63 - (p & 63));
+        while (true) {
+            std::uint64_t behindA = (sideA[w] >> 1) | (sideA[w + 1] << 63);
+            std::uint64_t behindB = (sideB[w] >> 1) | (sideB[w + 1] << 63);
+            std::uint64_t stops = (~line[w] | (sideA[w] & ~behindA) | (sideB[w] & ~behindB)) & mask;
+            if (stops) {
+                stop = (w << 6) + 63 - __builtin_clzll(stops) - 64;
+                break;
+            }
+            w--;
+            mask = ~0ULL;
+        }
+    }
+
+    // The goal is a jump point too if the scan reaches it first
+    if (goalPosition != -1 && (dir > 0 ? goalPosition >= from && goalPosition <= stop : goalPosition <= from && goalPosition >= stop)) {
+        return goalPosition;
+    }
+
+    int bit = stop + 64;
+    bool wall = !((line[bit >> 6] >> (bit & 63)) & 1);
+    return wall ? -1 : stop;
+}
+
+int JumpPointSearch::jump(int row, int col, int dr, int dc) const {
+    int goalRow = goal / cols;
+    int goalCol = goal % cols;
+
+    if (dr == 0) {
+        if (row < 0 || row >= rows || col < 0 || col >= cols) return -1;
+        const std::uint64_t* line = &rowBits[(size_t) (row + 1) * rowWords];
+        int stop = scanLine(line, line - rowWords, line + rowWords, col, dc, goalRow == row ? goalCol : -1);
+        return stop == -1 ? -1 : grid.cellId(row, stop);
+    }
+
+    if (dc == 0) {
+        if (row < 0 || row >= rows || col < 0 || col >= cols) return -1;
+        const std::uint64_t* line = &colBits[(size_t) (col + 1) * colWords];
+        int stop = scanLine(line, line - colWords, line + colWords, row, dr, goalCol == col ? goalRow : -1);
+        return stop == -1 ? -1 : grid.cellId(stop, col);
+    }
+
+    // Diagonal: stop wherever one of the two straight scans out of a tile finds something
+    while (true) {
+        if (!isOpen(row, col)) return -1;
+
+        int cell = grid.cellId(row, col);
+        if (cell == goal) return cell;
+
+        if (jump(row, col + dc, 0, dc) != -1 || jump(row + dr, col, dr, 0) != -1) return cell;
+
+        // The next diagonal move would cut a wall corner
+        if (!isOpen(row, col + dc) || !isOpen(row + dr, col)) return -1;
+
+        row += dr;
+        col += dc;
+    }
+}
+
+float JumpPointSearch::octile(int from, int to) const {
+    int dRows = std::abs(from / cols - to / cols);
+    int dCols = std::abs(from % cols - to % cols);
+    int diagonalMoves = std::min(dRows, dCols);
+
+    return diagonalMoves * diagonal + (dRows - diagonalMoves) * straightY + (dCols - diagonalMoves) * straightX;
+}
+
+bool JumpPointSearch::search(int start, int goalCell) {
+    sync();
+
+    int cellCount = rows * cols;
+    if (start < 0 || start >= cellCount || goalCell < 0 || goalCell >= cellCount) return false;
+    if (!isOpen(start / cols, start % cols) || !isOpen(goalCell / cols, goalCell % cols)) return false;
+
+    goal = goalCell;
+    context.begin(cellCount);
+    context.relax(start, 0, octile(start, goal), -1);
+
+    while (!context.empty()) {
+        auto entry = context.pop();
+        int cell = entry.second;
+
+        if (cell == goal) break;
+
+        if (context.isStale(entry)) continue;
+
+        int row = cell / cols;
+        int col = cell % cols;
+        float distance = context.getDistance(cell);
+
+        auto tryJump = [&](int dr, int dc) {
+            int next = jump(row + dr, col + dc, dr, dc);
+            if (next == -1) return;
+
+            float newDist = distance + octile(cell, next);
+            if (newDist < context.getDistance(next)) {
+                context.relax(next, newDist, newDist + octile(next, goal), cell);
+            }
+        };
+
+        int parent = context.getPrevious(cell);
+        if (parent == -1) {
+            // The start has no direction to prune by
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if (dr == 0 && dc == 0) continue;
+                    if (dr != 0 && dc != 0 && (!isOpen(row + dr, col) || !isOpen(row, col + dc))) continue;
+                    tryJump(dr, dc);
+                }
+            }
+            continue;
+        }
+
+        int dr = (row > parent / cols) - (row < parent / cols);
+        int dc = (col > parent % cols) - (col < parent % cols);
+
+        if (dr != 0 && dc != 0) {
+            bool verticalOpen = isOpen(row + dr, col);
+            bool horizontalOpen = isOpen(row, col + dc);
+            if (verticalOpen) tryJump(dr, 0);
+            if (horizontalOpen) tryJump(0, dc);
+            if (verticalOpen && horizontalOpen) tryJump(dr, dc);
+        }
+        else if (dc != 0) {
+            bool ahead = isOpen(row, col + dc);
+            bool up = isOpen(row - 1, col);
+            bool down = isOpen(row + 1, col);
+            if (ahead) {
+                tryJump(0, dc);
+                if (up) tryJump(-1, dc);
+                if (down) tryJump(1, dc);
+            }
+            if (up) tryJump(-1, 0);
+            if (down) tryJump(1, 0);
+        }
+        else {
+            bool ahead = isOpen(row + dr, col);
+            bool left = isOpen(row, col - 1);
+            bool right = isOpen(row, col + 1);
+            if (ahead) {
+                tryJump(dr, 0);
+                if (left) tryJump(dr, -1);
+                if (right) tryJump(dr, 1);
+            }
+            if (left) tryJump(0, -1);
+            if (right) tryJump(0, 1);
+        }
+    }
+
+    return context.getDistance(goal) < std::numeric_limits<float>::infinity();
+}
+
+int JumpPointSearch::astar(int start, int goalCell) {
+    if (!search(start, goalCell) || start == goalCell) return -1;
+
+    // Walk back to the first jump point, then take one move along the line towards it
+    int current = goalCell;
+    while (context.getPrevious(current) != start) {
+        current = context.getPrevious(current);
+    }
+
+    int dr = (current / cols > start / cols) - (current / cols < start / cols);
+    int dc = (current % cols > start % cols) - (current % cols < start % cols);
+    return grid.cellId(start / cols + dr, start % cols + dc);
+}
+
+bool JumpPointSearch::findPath(int start, int goalCell, Path& path) {
+    path.vertices.clear();
+    path.distance = 0;
+
+    if (!search(start, goalCell)) return false;
+
+    std::vector<int> jumpPoints;
+    for (int current = goalCell; current != -1; current = context.getPrevious(current)) {
+        jumpPoints.push_back(current);
+    }
+    std::reverse(jumpPoints.begin(), jumpPoints.end());
+
+    // Fill in the tiles along each straight or diagonal segment
+    path.vertices.push_back(start);
+    for (size_t i = 1; i < jumpPoints.size(); i++) {
+        int row = jumpPoints[i - 1] / cols;
+        int col = jumpPoints[i - 1] % cols;
+        int dr = (jumpPoints[i] / cols > row) - (jumpPoints[i] / cols < row);
+        int dc = (jumpPoints[i] % cols > col) - (jumpPoints[i] % cols < col);
+
+        while (grid.cellId(row, col) != jumpPoints[i]) {
+            row += dr;
+            col += dc;
+            path.vertices.push_back(grid.cellId(row, col));
+        }
+    }
+    path.distance = context.getDistance(goalCell);
+
+    return true;
+}
@@ -0,0 +1,103 @@
+#ifndef JUMP_POINT_SEARCH_H
+#define JUMP_POINT_SEARCH_H
+
+#include <cstdint>
+#include <vector>
+#include "OccupancyGrid.h"
+#include "PathCache.h"
+#include "SearchContext.h"
+
+/**
+ * Jump Point Search directly over an OccupancyGrid, with no explicit graph.
+ *
+ * Moves go to the 8 neighboring open tiles without cutting wall corners and cost the world
+ * distance between tile centers, the same rules as the grid FlowField. Straight runs are
+ * scanned 64 tiles at a time over bit-packed copies of the tiles, one copy per row and one
+ * per column. Only jump points, where a route may have to turn, reach the open list.
+ *
+ * The bit copies are refreshed automatically when the grid's version changes.
+ */
+class JumpPointSearch {
+private:
+    const OccupancyGrid& grid;
+    /** Grid version the bit copies were taken from */
+    unsigned long syncedVersion;
+    bool synced;
+
+    int rows;
+    int cols;
+    /** Words per bit line. Tile i of a line is bit i + 64, so the first and last words are always walls */
+    int rowWords;
+    int colWords;
+    /** Open bits of rows -1 to rows, row major; rows -1 and rows are walls */
+    std::vector<std::uint64_t> rowBits;
+    /** Open bits of columns -1 to cols, the transposed copy used for vertical scans */
+    std::vector<std::uint64_t> colBits;
+
+    /** Move costs in world units */
+    float straightX;
+    float straightY;
+    float diagonal;
+
+    /** Scratch space indexed by cell id */
+    SearchContext context;
+    /** Goal of the search currently running */
+    int goal;
+
+    /**
+     * Copy the tiles into the bit lines if the grid changed
+     */
+    void sync();
+
+    bool isOpen(int row, int col) const;
+
+    /**
+     * Scan one line from position from in direction dir until the next jump point
+     *
+     * @param line Bits of the line scanned
+     * @param sideA Bits of one neighboring line
+     * @param sideB Bits of the other neighboring line
+     * @param goalPosition Position of the goal on this line, -1 if it is not on it
+     * @return the position of the jump point, or -1 if the scan hits a wall first
+     */
+    static int scanLine(const std::uint64_t* line, const std::uint64_t* sideA, const std::uint64_t* sideB,
+                        int from, int dir, int goalPosition);
+
+    /**
+     * Jump from the tile (row, col), entered by moving (dr, dc), to the next jump point
+     *
+     * @return its cell id, or -1 if there is none in that direction
+     */
+    int jump(int row, int col, int dr, int dc) const;
+
+    /**
+     * Octile distance between two cells with the world move costs
+     */
+    float octile(int from, int to) const;
+
+    /**
+     * Run the search into context. Return true if goal was reached
+     */
+    bool search(int start, int goal);
+
+public:
+
+    /**
+     * @param grid The grid to search. It must outlive the searcher
+     */
+    JumpPointSearch(const OccupancyGrid& grid);
+
+    /**
+     * Get the neighboring cell to move to from start towards goal, -1 if unreachable
+     */
+    int astar(int start, int goal);
+
+    /**
+     * Fill path with every cell from start to goal
+     *
+     * @return if goal is reachable
+     */
+    bool findPath(int start, int goal, Path& path);
+};
+
+#endif
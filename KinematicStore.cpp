@@ -0,0 +1,281 @@
+#include "KinematicStore.h"
+#include <algorithm>
+#include <cmath>
+#include "VectorUtils.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Float constants, so the scalar and SIMD paths round exactly the same way
+static const float PI_F = (float) M_PI;
+static const float TWO_PI_F = (float) (2 * M_PI);
+
+// Orientations stay within -PI to PI, so one step around the circle is almost always enough
+static inline float wrapAngle(float angle) {
+    if (angle > PI_F) angle -= TWO_PI_F;
+    else if (angle < -PI_F) angle += TWO_PI_F;
+
+    while (angle > PI_F) angle -= TWO_PI_F;
+    while (angle < -PI_F) angle += TWO_PI_F;
+    return angle;
+}
+
+KinematicStore::KinematicStore() : integrationMode(SIMD) {
+}
+
+int KinematicStore::add(const Kinematic& kinematic, Kind kind) {
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = size();
+        positionX.push_back(0);
+        positionY.push_back(0);
+        velocityX.push_back(0);
+        velocityY.push_back(0);
+        orientation.push_back(0);
+        rotation.push_back(0);
+        maxSpeed.push_back(0);
+        maxRotation.push_back(0);
+        linearX.push_back(0);
+        linearY.push_back(0);
+        angular.push_back(0);
+        previousX.push_back(0);
+        previousY.push_back(0);
+        previousOrientation.push_back(0);
+        ids.push_back(-1);
+        kinds.push_back(FREE);
+    }
+
+    set(slot, kinematic);
+    previousX[slot] = positionX[slot];
+    previousY[slot] = positionY[slot];
+    previousOrientation[slot] = orientation[slot];
+    linearX[slot] = 0;
+    linearY[slot] = 0;
+    angular[slot] = 0;
+    kinds[slot] = kind;
+
+    return slot;
+}
+
+void KinematicStore::remove(int slot) {
+    if (slot < 0 || slot >= size() || kinds[slot] == FREE) return;
+
+    set(slot, Kinematic());
+    linearX[slot] = 0;
+    linearY[slot] = 0;
+    angular[slot] = 0;
+    kinds[slot] = FREE;
+    freeSlots.push_back(slot);
+}
+
+Kinematic KinematicStore::get(int slot) const {
+    Kinematic kinematic;
+    kinematic.id = ids[slot];
+    kinematic.position = sf::Vector2f(positionX[slot], positionY[slot]);
+    kinematic.velocity = sf::Vector2f(velocityX[slot], velocityY[slot]);
+    kinematic.orientation = orientation[slot];
+    kinematic.rotation = rotation[slot];
+    kinematic.maxSpeed = maxSpeed[slot];
+    kinematic.maxRotation = maxRotation[slot];
+    return kinematic;
+}
+
+void KinematicStore::set(int slot, const Kinematic& kinematic) {
+    ids[slot] = kinematic.id;
+    positionX[slot] = kinematic.position.x;
+    positionY[slot] = kinematic.position.y;
+    velocityX[slot] = kinematic.velocity.x;
+    velocityY[slot] = kinematic.velocity.y;
+    orientation[slot] = kinematic.orientation;
+    rotation[slot] = kinematic.rotation;
+    maxSpeed[slot] = kinematic.maxSpeed;
+    maxRotation[slot] = kinematic.maxRotation;
+}
+
+void KinematicStore::setPosition(int slot, const sf::Vector2f& position) {
+    positionX[slot] = position.x;
+    positionY[slot] = position.y;
+}
+
+void KinematicStore::setVelocity(int slot, const sf::Vector2f& velocity) {
+    velocityX[slot] = velocity.x;
+    velocityY[slot] = velocity.y;
+}
+
+void KinematicStore::setOrientation(int slot, float newOrientation) {
+    orientation[slot] = VectorUtils::mapToPiRange(newOrientation);
+}
+
+void KinematicStore::setRotation(int slot, float newRotation) {
+    rotation[slot] = newRotation;
+}
+
+void KinematicStore::setSteering(int slot, const SteeringOutput& steering) {
+    linearX[slot] = steering.linear.x;
+    linearY[slot] = steering.linear.y;
+    angular[slot] = steering.angular;
+}
+
+void KinematicStore::integrate(float deltaTime) {
+    if (integrationMode == SIMD) {
+        integrateSimd(deltaTime);
+    }
+    else {
+        integrateScalar(0, size(), deltaTime);
+    }
+}
+
+void KinematicStore::integrateScalar(int begin, int end, float deltaTime) {
+    for (int i = begin; i < end; i++) {
+        previousX[i] = positionX[i];
+        previousY[i] = positionY[i];
+        previousOrientation[i] = orientation[i];
+
+        positionX[i] += velocityX[i] * deltaTime;
+        positionY[i] += velocityY[i] * deltaTime;
+        orientation[i] = wrapAngle(orientation[i] + rotation[i] * deltaTime);
+
+        float vx = velocityX[i] + linearX[i] * deltaTime;
+        float vy = velocityY[i] + linearY[i] * deltaTime;
+
+        // Max velocity if it tries to go over. One sqrt and a division, both exactly rounded
+        float speedSquared = vx * vx + vy * vy;
+        if (speedSquared > maxSpeed[i] * maxSpeed[i]) {
+            float scale = maxSpeed[i] / std::sqrt(speedSquared);
+            vx *= scale;
+            vy *= scale;
+        }
+        velocityX[i] = vx;
+        velocityY[i] = vy;
+
+        // Max rotation if it tries to go over. Written like _mm_min_ps/_mm_max_ps, which differ
+        // from std::min/std::max on signed zeros
+        float spin = rotation[i] + angular[i] * deltaTime;
+        spin = spin < maxRotation[i] ? spin : maxRotation[i];
+        rotation[i] = -maxRotation[i] > spin ? -maxRotation[i] : spin;
+
+        linearX[i] = 0;
+        linearY[i] = 0;
+        angular[i] = 0;
+    }
+}
+
+#ifdef __SSE2__
+
+void KinematicStore::integrateSimd(float deltaTime) {
+    int count = size();
+    int blocked = count - count % 4;
+
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    const __m128 pi = _mm_set1_ps(PI_F);
+    const __m128 negativePi = _mm_set1_ps(-PI_F);
+    const __m128 twoPi = _mm_set1_ps(TWO_PI_F);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    // Every step is the same IEEE operation, in the same order, as integrateScalar. Blends pick
+    // between results instead of branching, and multiplying by exactly 1 leaves a value unchanged.
+    // This holds as long as the compiler does not fuse the scalar multiply-adds (-ffp-contract=off,
+    // the default under -std=c++17)
+    for (int i = 0; i < blocked; i += 4) {
+        __m128 x = _mm_loadu_ps(&positionX[i]);
+        __m128 y = _mm_loadu_ps(&positionY[i]);
+        __m128 vx = _mm_loadu_ps(&velocityX[i]);
+        __m128 vy = _mm_loadu_ps(&velocityY[i]);
+        __m128 o = _mm_loadu_ps(&orientation[i]);
+        __m128 r = _mm_loadu_ps(&rotation[i]);
+
+        _mm_storeu_ps(&previousX[i], x);
+        _mm_storeu_ps(&previousY[i], y);
+        _mm_storeu_ps(&previousOrientation[i], o);
+
+        _mm_storeu_ps(&positionX[i], _mm_add_ps(x, _mm_mul_ps(vx, dt)));
+        _mm_storeu_ps(&positionY[i], _mm_add_ps(y, _mm_mul_ps(vy, dt)));
+
+        o = _mm_add_ps(o, _mm_mul_ps(r, dt));
+        __m128 above = _mm_cmpgt_ps(o, pi);
+        __m128 below = _mm_cmplt_ps(o, negativePi);
+        __m128 wrapped = _mm_or_ps(_mm_and_ps(above, _mm_sub_ps(o, twoPi)), _mm_andnot_ps(above, o));
+        wrapped = _mm_or_ps(_mm_and_ps(below, _mm_add_ps(o, twoPi)), _mm_andnot_ps(below, wrapped));
+        _mm_storeu_ps(&orientation[i], wrapped);
+
+        // A lane more than a full turn out of range takes the scalar loop, like integrateScalar
+        if (_mm_movemask_ps(_mm_or_ps(_mm_cmpgt_ps(wrapped, pi), _mm_cmplt_ps(wrapped, negativePi)))) {
+            for (int lane = i; lane < i + 4; lane++) {
+                orientation[lane] = wrapAngle(orientation[lane]);
+            }
+        }
+
+        vx = _mm_add_ps(vx, _mm_mul_ps(_mm_loadu_ps(&linearX[i]), dt));
+        vy = _mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(&linearY[i]), dt));
+
+        __m128 limit = _mm_loadu_ps(&maxSpeed[i]);
+        __m128 speedSquared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        __m128 over = _mm_cmpgt_ps(speedSquared, _mm_mul_ps(limit, limit));
+        __m128 scale = _mm_div_ps(limit, _mm_sqrt_ps(speedSquared));
+        scale = _mm_or_ps(_mm_and_ps(over, scale), _mm_andnot_ps(over, one));
+        _mm_storeu_ps(&velocityX[i], _mm_mul_ps(vx, scale));
+        _mm_storeu_ps(&velocityY[i], _mm_mul_ps(vy, scale));
+
+        __m128 maxSpin = _mm_loadu_ps(&maxRotation[i]);
+        __m128 spin = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&angular[i]), dt));
+        spin = _mm_max_ps(_mm_xor_ps(maxSpin, signBit), _mm_min_ps(spin, maxSpin));
+        _mm_storeu_ps(&rotation[i], spin);
+
+        _mm_storeu_ps(&linearX[i], zero);
+        _mm_storeu_ps(&linearY[i], zero);
+        _mm_storeu_ps(&angular[i], zero);
+    }
+
+    integrateScalar(blocked, count, deltaTime);
+}
+
+#else
+
+void KinematicStore::integrateSimd(float deltaTime) {
+    integrateScalar(0, size(), deltaTime);
+}
+
+#endif
+
+void KinematicStore::setIntegrationMode(IntegrationMode mode) {
+    integrationMode = mode;
+}
+
+KinematicStore::IntegrationMode KinematicStore::getIntegrationMode() const {
+    return integrationMode;
+}
+
+void KinematicStore::wrap(float width, float height, float margin) {
+    int count = size();
+
+    for (int i = 0; i < count; i++) {
+        if (positionX[i] < -margin) positionX[i] = width;
+        else if (positionX[i] > width + margin) positionX[i] = 0;
+
+        if (positionY[i] < -margin) positionY[i] = height;
+        else if (positionY[i] > height + margin) positionY[i] = 0;
+    }
+}
+
+void KinematicStore::queryRadius(const sf::Vector2f& center, float radius, Kind kind, std::vector<int>& out) const {
+    out.clear();
+    int count = size();
+    float radiusSquared = radius * radius;
+
+    for (int i = 0; i < count; i++) {
+        float dx = positionX[i] - center.x;
+        float dy = positionY[i] - center.y;
+        if (kinds[i] == kind && dx * dx + dy * dy < radiusSquared) out.push_back(i);
+    }
+}
+
+int KinematicStore::size() const {
+    return (int) positionX.size();
+}
@@ -0,0 +1,174 @@
+#ifndef KINEMATIC_STORE_H
+#define KINEMATIC_STORE_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "Kinematic.h"
+#include "SteeringOutput.h"
+
+/**
+ * Structure-of-arrays storage for the kinematics of every agent.
+ *
+ * Entity, Monster and LearningMonster each hold a slot index instead of their own Kinematic.
+ * Their update only decides on a steering output; integrate() then moves every agent in one
+ * pass over contiguous float arrays, and wrap() and the neighbor scans stream the same way.
+ * Slots of removed agents are reused by the next add().
+ */
+class KinematicStore {
+public:
+
+    /** Which integrate() implementation runs */
+    enum IntegrationMode {
+        /** One slot at a time; the reference the other modes match bit for bit */
+        SCALAR,
+        /** Four slots per SSE2 instruction, falling back to SCALAR where SSE2 is missing */
+        SIMD
+    };
+
+    /** Which kind of agent owns a slot */
+    enum Kind {
+        FREE,
+        ENTITY,
+        MONSTER,
+        LEARNING_MONSTER
+    };
+
+private:
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> orientation;
+    std::vector<float> rotation;
+    std::vector<float> maxSpeed;
+    std::vector<float> maxRotation;
+
+    /** Steering requested since the last integrate() */
+    std::vector<float> linearX;
+    std::vector<float> linearY;
+    std::vector<float> angular;
+
+    /** State before the last integrate(), for render interpolation */
+    std::vector<float> previousX;
+    std::vector<float> previousY;
+    std::vector<float> previousOrientation;
+
+    std::vector<int> ids;
+    std::vector<Kind> kinds;
+    std::vector<int> freeSlots;
+
+    IntegrationMode integrationMode;
+
+    /**
+     * Integrate the slots in [begin, end) one at a time
+     */
+    void integrateScalar(int begin, int end, float deltaTime);
+
+    /**
+     * Integrate every slot four at a time, the leftovers through integrateScalar
+     */
+    void integrateSimd(float deltaTime);
+
+public:
+
+    KinematicStore();
+
+    /**
+     * Take a slot for a new agent
+     *
+     * @param kinematic The agent's starting state, also used as its previous state
+     * @param kind The kind of agent
+     * @return The slot the agent keeps
+     */
+    int add(const Kinematic& kinematic, Kind kind);
+
+    /**
+     * Free a slot. It is zeroed so the streaming passes can run over it harmlessly
+     */
+    void remove(int slot);
+
+    /**
+     * Gather a slot into a Kinematic
+     */
+    Kinematic get(int slot) const;
+
+    /**
+     * Scatter a Kinematic into a slot. The previous state is left alone
+     */
+    void set(int slot, const Kinematic& kinematic);
+
+    sf::Vector2f getPosition(int slot) const {
+        return sf::Vector2f(positionX[slot], positionY[slot]);
+    }
+
+    sf::Vector2f getPreviousPosition(int slot) const {
+        return sf::Vector2f(previousX[slot], previousY[slot]);
+    }
+
+    float getOrientation(int slot) const {
+        return orientation[slot];
+    }
+
+    float getPreviousOrientation(int slot) const {
+        return previousOrientation[slot];
+    }
+
+    void setPosition(int slot, const sf::Vector2f& position);
+
+    void setVelocity(int slot, const sf::Vector2f& velocity);
+
+    /**
+     * Set the orientation, mapped to -PI to PI
+     */
+    void setOrientation(int slot, float newOrientation);
+
+    void setRotation(int slot, float newRotation);
+
+    /**
+     * Request the acceleration the next integrate() applies to a slot
+     */
+    void setSteering(int slot, const SteeringOutput& steering);
+
+    /**
+     * Move every agent by its velocity and steer it by its requested acceleration, clamped to
+     * its limits, then clear the requests. The state before the step is kept for interpolation
+     *
+     * @param deltaTime Seconds to advance
+     */
+    void integrate(float deltaTime);
+
+    /**
+     * Choose the integrate() implementation. Both give identical results
+     */
+    void setIntegrationMode(IntegrationMode mode);
+
+    IntegrationMode getIntegrationMode() const;
+
+    /**
+     * Send agents that left [0, width] x [0, height] by more than margin to the opposite side
+     */
+    void wrap(float width, float height, float margin);
+
+    /**
+     * Slots of one kind within radius of a point
+     *
+     * @param out Cleared, then filled with the slots found
+     */
+    void queryRadius(const sf::Vector2f& center, float radius, Kind kind, std::vector<int>& out) const;
+
+    /**
+     * Number of slots, free ones included. Loops over the arrays below run to this
+     */
+    int size() const;
+
+    const float* getPositionX() const { return positionX.data(); }
+    const float* getPositionY() const { return positionY.data(); }
+    const float* getVelocityX() const { return velocityX.data(); }
+    const float* getVelocityY() const { return velocityY.data(); }
+    const float* getOrientations() const { return orientation.data(); }
+    const float* getRotations() const { return rotation.data(); }
+    const int* getIds() const { return ids.data(); }
+    const Kind* getKinds() const { return kinds.data(); }
+};
+
+#endif
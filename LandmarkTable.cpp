@@ -0,0 +1,251 @@
+#include "LandmarkTable.h"
+#include "Graph.h"
+#include <iomanip>
+#include <limits>
+
+LandmarkTable::LandmarkTable() : vertexCount(0), edgeCount(0), edgeChecksum(0), directed(false) {
+}
+
+LandmarkTable::GoalBound::GoalBound(const LandmarkTable& table, int goal) : table(table) {
+    if (goal < 0 || goal >= table.vertexCount) return;
+
+    for (size_t k = 0; k < table.landmarks.size(); k++) {
+        size_t row = k * table.vertexCount;
+        fromGoal.push_back(table.fromLandmark[row + goal]);
+        toGoal.push_back(table.directed ? table.toLandmark[row + goal] : 0);
+    }
+}
+
+void LandmarkTable::build(const Graph& graph, int count, bool isDirected) {
+
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    clear();
+    vertexCount = graph.getVertexCount();
+    edgeCount = graph.getEdgeCount();
+    edgeChecksum = graph.getEdgeChecksum();
+    directed = isDirected;
+    if (vertexCount == 0 || count <= 0) return;
+
+    // Distances to a landmark are distances from it on the reversed graph
+    std::vector<std::vector<std::pair<int, float>>> reverseEdges;
+    if (directed) {
+        reverseEdges.resize(vertexCount);
+        for (int u = 0; u < vertexCount; u++) {
+            graph.forEachNeighbor(u, [&](int v, float weight) {
+                reverseEdges[v].push_back({u, weight});
+            });
+        }
+    }
+
+    SearchContext context;
+    auto fullDijkstra = [&](int source, bool reverse, std::vector<float>& out) {
+        context.begin(vertexCount);
+        context.relax(source, 0, 0, -1);
+
+        while (!context.empty()) {
+            auto entry = context.pop();
+            if (context.isStale(entry)) continue;
+
+            int current = entry.second;
+            float distance = context.getDistance(current);
+            auto visit = [&](int neighbor, float weight) {
+                float newDistance = distance + weight;
+                if (newDistance < context.getDistance(neighbor)) {
+                    context.relax(neighbor, newDistance, newDistance, current);
+                }
+            };
+
+            if (reverse) {
+                for (const auto& [neighbor, weight] : reverseEdges[current]) visit(neighbor, weight);
+            }
+            else {
+                graph.forEachNeighbor(current, visit);
+            }
+        }
+
+        for (int v = 0; v < vertexCount; v++) {
+            out.push_back(context.getDistance(v));
+        }
+    };
+
+    // Farthest-point selection: start from the vertex farthest from vertex 0,
+    // then keep adding the vertex farthest from every landmark chosen so far
+    std::vector<float> distances;
+    fullDijkstra(0, false, distances);
+    std::vector<float> minDistance(vertexCount, infinity);
+    for (int v = 0; v < vertexCount; v++) {
+        minDistance[v] = distances[v] == infinity ? -1 : distances[v];
+    }
+
+    for (int i = 0; i < count && i < vertexCount; i++) {
+
+        // Unreached vertices read as infinity, so new components get a landmark first
+        int next = 0;
+        for (int v = 1; v < vertexCount; v++) {
+            if (minDistance[v] > minDistance[next]) next = v;
+        }
+        if (minDistance[next] <= 0 && i > 0) break;
+
+        landmarks.push_back(next);
+        fullDijkstra(next, false, fromLandmark);
+        if (directed) fullDijkstra(next, true, toLandmark);
+
+        const float* from = &fromLandmark[(size_t) i * vertexCount];
+        for (int v = 0; v < vertexCount; v++) {
+            if (i == 0 || minDistance[v] < 0) minDistance[v] = from[v];
+            else minDistance[v] = std::min(minDistance[v], from[v]);
+        }
+        minDistance[next] = 0;
+    }
+}
+
+float LandmarkTable::lowerBound(int v, int goal) const {
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    if (v < 0 || v >= vertexCount || goal < 0 || goal >= vertexCount) return 0;
+
+    float best = 0;
+    for (size_t k = 0; k < landmarks.size(); k++) {
+        size_t row = k * vertexCount;
+
+        // d(v, goal) >= d(L, goal) - d(L, v)
+        float fromGoal = fromLandmark[row + goal];
+        float fromV = fromLandmark[row + v];
+        if (fromGoal != infinity && fromV != infinity) {
+            best = std::max(best, directed ? fromGoal - fromV : std::fabs(fromGoal - fromV));
+        }
+
+        // d(v, goal) >= d(v, L) - d(goal, L)
+        if (directed) {
+            float toV = toLandmark[row + v];
+            float toGoal = toLandmark[row + goal];
+            if (toV != infinity && toGoal != infinity) {
+                best = std::max(best, toV - toGoal);
+            }
+        }
+    }
+    return best;
+}
+
+bool LandmarkTable::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    // Enough digits for every float to read back exactly, so bounds stay admissible
+    file << std::setprecision(9);
+    file << "landmarks," << landmarks.size() << "," << vertexCount << "," << edgeCount << "," << (directed ? 1 : 0) << "," << edgeChecksum << "\n";
+
+    auto writeRows = [&](const char* name, const std::vector<float>& table) {
+        for (size_t k = 0; k < landmarks.size(); k++) {
+            file << name << "," << landmarks[k];
+            for (int v = 0; v < vertexCount; v++) {
+                file << "," << table[k * vertexCount + v];
+            }
+            file << "\n";
+        }
+    };
+
+    writeRows("from", fromLandmark);
+    if (directed) writeRows("to", toLandmark);
+
+    file.close();
+    return true;
+}
+
+bool LandmarkTable::load(const std::string& path, const Graph& graph, bool isDirected) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    clear();
+
+    std::string line;
+    bool haveHeader = false;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<std::string> row;
+        while (std::getline(ss, cell, ',')) {
+            row.push_back(cell);
+        }
+        if (row.empty()) continue;
+
+        // Exactly one header, first: the rows are only sized and checked against the graph through it
+        if (haveHeader == (row[0] == "landmarks")) {
+            clear();
+            return false;
+        }
+
+        try {
+            if (row[0] == "landmarks") {
+                // Tables saved before the checksum was added cannot be checked, so they are rebuilt
+                if (row.size() < 6) {
+                    clear();
+                    return false;
+                }
+                vertexCount = std::stoi(row[2]);
+                edgeCount = std::stol(row[3]);
+                directed = std::stoi(row[4]) != 0;
+                edgeChecksum = std::stoull(row[5]);
+
+                // A table for a different graph, or the same edges reweighted, would give wrong bounds
+                if (vertexCount != graph.getVertexCount() || edgeCount != graph.getEdgeCount() || directed != isDirected
+                    || edgeChecksum != graph.getEdgeChecksum()) {
+                    clear();
+                    return false;
+                }
+                haveHeader = true;
+            }
+            else if ((row[0] == "from" || row[0] == "to") && (int) row.size() == vertexCount + 2) {
+                std::vector<float>& table = row[0] == "from" ? fromLandmark : toLandmark;
+                if (row[0] == "from") {
+                    int landmark = std::stoi(row[1]);
+                    if (landmark < 0 || landmark >= vertexCount) {
+                        clear();
+                        return false;
+                    }
+                    landmarks.push_back(landmark);
+                }
+                for (int v = 0; v < vertexCount; v++) {
+                    table.push_back(std::stof(row[v + 2]));
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Conversion Error: " << e.what() << " in " << path << std::endl;
+            clear();
+            return false;
+        }
+    }
+
+    file.close();
+
+    size_t expected = landmarks.size() * vertexCount;
+    if (landmarks.empty() || fromLandmark.size() != expected || (directed && toLandmark.size() != expected)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+void LandmarkTable::clear() {
+    landmarks.clear();
+    fromLandmark.clear();
+    toLandmark.clear();
+    vertexCount = 0;
+    edgeCount = 0;
+    edgeChecksum = 0;
+    directed = false;
+}
+
+bool LandmarkTable::empty() const {
+    return landmarks.empty();
+}
+
+const std::vector<int>& LandmarkTable::getLandmarks() const {
+    return landmarks;
+}
@@ -0,0 +1,116 @@
+#ifndef LANDMARK_TABLE_H
+#define LANDMARK_TABLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+class Graph;
+
+/**
+ * Precomputed landmark distances for the ALT (A*, Landmarks, Triangle inequality) heuristic.
+ *
+ * For every landmark L the table stores d(L, v) and, on directed graphs, d(v, L) for all
+ * vertices. The triangle inequality turns those into a lower bound on d(v, goal) that is
+ * admissible for any non-negative edge weights, unlike the straight-line heuristics.
+ */
+class LandmarkTable {
+private:
+    /** Number of vertices the table was built for */
+    int vertexCount;
+    /** Number of adjacency entries the table was built for, used to reject stale files */
+    long edgeCount;
+    /** Graph::getEdgeChecksum of the graph the table was built for, so reweighted edges are caught too */
+    uint64_t edgeChecksum;
+    /** If d(v, L) is stored separately from d(L, v) */
+    bool directed;
+    /** The landmark vertices */
+    std::vector<int> landmarks;
+    /** d(L, v), landmark major: [k * vertexCount + v] */
+    std::vector<float> fromLandmark;
+    /** d(v, L), landmark major. Empty on undirected graphs */
+    std::vector<float> toLandmark;
+
+public:
+
+    /**
+     * lowerBound towards one fixed goal. The goal's distances are gathered once and the
+     * bound is inline, so a search can evaluate it without a call per vertex
+     */
+    class GoalBound {
+    private:
+        const LandmarkTable& table;
+        /** d(L, goal) and d(goal, L) for every landmark */
+        std::vector<float> fromGoal;
+        std::vector<float> toGoal;
+
+    public:
+        GoalBound(const LandmarkTable& table, int goal);
+
+        float operator()(int v) const {
+            const float infinity = std::numeric_limits<float>::infinity();
+
+            float best = 0;
+            for (size_t k = 0; k < fromGoal.size(); k++) {
+                size_t row = k * table.vertexCount;
+
+                float fromV = table.fromLandmark[row + v];
+                if (fromGoal[k] != infinity && fromV != infinity) {
+                    best = std::max(best, table.directed ? fromGoal[k] - fromV : std::fabs(fromGoal[k] - fromV));
+                }
+
+                if (table.directed) {
+                    float toV = table.toLandmark[row + v];
+                    if (toV != infinity && toGoal[k] != infinity) {
+                        best = std::max(best, toV - toGoal[k]);
+                    }
+                }
+            }
+            return best;
+        }
+    };
+
+    LandmarkTable();
+
+    /**
+     * Pick landmarks by farthest-point selection and run one full Dijkstra per landmark
+     *
+     * @param graph The graph to precompute
+     * @param count The number of landmarks
+     * @param directed If the graph is directed, so reverse distances are needed too
+     */
+    void build(const Graph& graph, int count, bool directed);
+
+    /**
+     * Lower bound on the cost of any route from v to goal
+     */
+    float lowerBound(int v, int goal) const;
+
+    /**
+     * Write the table as csv
+     *
+     * @return if the file was written
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * Read a table written by save, rejecting it if it does not match the graph
+     *
+     * @return if a matching table was loaded
+     */
+    bool load(const std::string& path, const Graph& graph, bool directed);
+
+    /**
+     * Drop the table
+     */
+    void clear();
+
+    bool empty() const;
+
+    const std::vector<int>& getLandmarks() const;
+};
+
+#endif
@@ -1,11 +1,12 @@
 #include "LearningMonster.h"
 #include "SteeringBehavior.h"
 
-LearningMonster::LearningMonster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision, const std::string dataPath) 
-: visionCircle(vision, (int) vision), visionDist(vision) {
+LearningMonster::LearningMonster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision, const std::string dataPath, KinematicStore& kinematics) 
+: visionCircle(vision, (int) vision), kinematics(kinematics), visionDist(vision) {
 
 
-    if (!texture.loadFromFile(textureFile)) {
+    // No texture file means a headless run; the sprite is never drawn
+    if (!textureFile.empty() && !texture.loadFromFile(textureFile)) {
         throw std::runtime_error("Failed to load text: " + textureFile);
     }
 
@@ -16,6 +17,7 @@ LearningMonster::LearningMonster(const int id, const std::string& textureFile, c
     sprite.setOrigin(5, 3.5);
 
     // Initialize basic stats
+    Kinematic kinematic;
     kinematic.id = id;
 
     kinematic.position = startPos;
@@ -28,6 +30,7 @@ LearningMonster::LearningMonster(const int id, const std::string& textureFile, c
     kinematic.maxRotation = M_PI / 4;
 
     sprite.setPosition(kinematic.position);
+    slot = kinematics.add(kinematic, KinematicStore::LEARNING_MONSTER);
 
     thirst = 60.0;
     
@@ -42,6 +45,7 @@ LearningMonster::LearningMonster(const int id, const std::string& textureFile, c
 }
 
 LearningMonster::~LearningMonster() {
+    kinematics.remove(slot);
 }
 
 void LearningMonster::update(float deltaTime) {
@@ -68,6 +72,7 @@ void LearningMonster::update(float deltaTime) {
 
     
 
+    Kinematic kinematic = getKinematic();
     targetKinematic = kinematic;
 
     if (target != nullptr) {
@@ -84,66 +89,51 @@ void LearningMonster::update(float deltaTime) {
         total.angular += output.angular;
     }
 
-    kinematic.position += kinematic.velocity * deltaTime;
-    kinematic.orientation += kinematic.rotation * deltaTime;;
-
-    kinematic.velocity += total.linear * deltaTime;
-    kinematic.rotation += total.angular * deltaTime;
-
-    // Max velocity if it tires to go over
-    if (VectorUtils::vector2Length(kinematic.velocity) > kinematic.maxSpeed) {
-        kinematic.velocity = VectorUtils::normalize(kinematic.velocity) * kinematic.maxSpeed;
-    }
-
-    // Max rotation if it tries to go over
-    if (std::fabs(kinematic.rotation) > kinematic.maxRotation) {
-        kinematic.rotation = (int) std::copysign(1.0f, kinematic.rotation) * kinematic.maxRotation;
-    }
-
-    setPosition(kinematic.position);
-    setOrientation(kinematic.orientation);
-    setKinematic(kinematic);
-
-    visionCircle.setPosition(kinematic.position);
+    // Game integrates every agent at once through the KinematicStore
+    kinematics.setSteering(slot, total);
 
     std::cout << currentAction << std::endl;
 
     thirst -= deltaTime;
 }
-void LearningMonster::render(sf::RenderWindow& window) {
+void LearningMonster::render(sf::RenderWindow& window, float alpha) {
+    sf::Vector2f position = VectorUtils::lerp(kinematics.getPreviousPosition(slot), kinematics.getPosition(slot), alpha);
+    visionCircle.setPosition(position);
+    sprite.setPosition(position);
+    sprite.setRotation(VectorUtils::radiansToDegrees(VectorUtils::lerpOrientation(kinematics.getPreviousOrientation(slot), kinematics.getOrientation(slot), alpha)));
+
     window.draw(visionCircle);
     window.draw(sprite);
 } 
 
 void LearningMonster::setPosition(const sf::Vector2f &newPosition) {
-    kinematic.position = newPosition;
-    sprite.setPosition(kinematic.position);
+    kinematics.setPosition(slot, newPosition);
+    sprite.setPosition(newPosition);
 }
 
 
 void LearningMonster::setVelocity(const sf::Vector2f &newVelocity) {
-    kinematic.velocity = newVelocity;
+    kinematics.setVelocity(slot, newVelocity);
 }
 
 
 void LearningMonster::setOrientation(const float newOrientation) {
-    kinematic.orientation = newOrientation;
-    // Ensure the angle is in the range 0 to 2p
-    kinematic.orientation = VectorUtils::mapToPiRange(kinematic.orientation);
+    // Ensure the angle is in the range -PI to PI
+    kinematics.setOrientation(slot, newOrientation);
 
     // Set rotation of sprite in degrees
-    float rot_degrees = VectorUtils::radiansToDegrees(kinematic.orientation);
+    float rot_degrees = VectorUtils::radiansToDegrees(kinematics.getOrientation(slot));
     sprite.setRotation(rot_degrees);
 }
 
 
 void LearningMonster::setRotation(const float newRotation) {
-    kinematic.rotation = newRotation;
+    kinematics.setRotation(slot, newRotation);
 }
 
 
 void LearningMonster::setKinematic(Kinematic &kin) {
-    kinematic = kin;
+    kinematics.set(slot, kin);
 }
 
 void LearningMonster::setTargetKinematic(Kinematic &kin) {
@@ -151,7 +141,7 @@ void LearningMonster::setTargetKinematic(Kinematic &kin) {
 }
 
 Kinematic LearningMonster::getKinematic() {
-    return kinematic;
+    return kinematics.get(slot);
 }
 
 void LearningMonster::addSteeringBehavior(std::unique_ptr<SteeringBehavior> behavior) {
@@ -175,12 +165,11 @@ void LearningMonster::wander() {
 
 void LearningMonster::chasePlayer() {
     clearSteeringBehaviors();
-    for (auto entity : Game::getInstance().getEntities()) {
-        // If a target was found
-        if (VectorUtils::vector2Length(entity->getKinematic().position - kinematic.position) < visionDist) {
-            target = entity;
-        }
-    } 
+    // Chase the last one found, as the full scan used to
+    std::vector<Entity*> visible = Game::getInstance().getEntitiesNear(kinematics.getPosition(slot), visionDist);
+    if (!visible.empty()) {
+        target = visible.back();
+    }
     addSteeringBehavior(std::make_unique<Arrive>(15, 0.1, 10, 40));
     addSteeringBehavior(std::make_unique<Align>(M_PI / 6, 0.1, M_PI / 32, M_PI / 8));
 }
@@ -194,7 +183,7 @@ void LearningMonster::attackTarget() {
 
 void LearningMonster::pathToWater() {
     clearSteeringBehaviors();
-    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position);
+    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot));
     targetPos = water->getPosition();
     addSteeringBehavior(std::make_unique<Arrive>(15, 0.1, 10, 30));
     addSteeringBehavior(std::make_unique<Align>(M_PI / 6, 0.1, M_PI / 32, M_PI / 8));
@@ -207,8 +196,8 @@ void LearningMonster::drinkWater() {
 bool LearningMonster::canSeeWater() {
     std::cout << "Check See Water";
     // Get closest water
-    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position);
-    if (VectorUtils::vector2Length(water->getKinematic().position - kinematic.position) < visionDist) {
+    Breadcrumb* water = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot));
+    if (VectorUtils::vector2Length(water->getKinematic().position - kinematics.getPosition(slot)) < visionDist) {
         targetPos = water->getKinematic().position;
         std::cout << " True" << std::endl;
         return true;
@@ -229,7 +218,7 @@ bool LearningMonster::canSeePlayer() {
     std::cout << "Check See Player";
     // If the Monster already had a target
     if (target != nullptr) {
-        if (VectorUtils::vector2Length(targetPos - kinematic.position) < visionDist) {
+        if (VectorUtils::vector2Length(targetPos - kinematics.getPosition(slot)) < visionDist) {
             std::cout << " True" << std::endl;
             return true;
         }
@@ -241,21 +230,18 @@ bool LearningMonster::canSeePlayer() {
     }
 
     // If the Monster didn't have a target already, check to see if it can find one
-    std::vector<Entity*> entities =  Game::getInstance().getEntities();
-    for (auto entity : entities) {
-        // If a target was found
-        if (VectorUtils::vector2Length(entity->getKinematic().position - kinematic.position) < visionDist) {
-            target = entity;
-            std::cout << " True" << std::endl;
-            return true;
-        }
+    std::vector<Entity*> visible = Game::getInstance().getEntitiesNear(kinematics.getPosition(slot), visionDist);
+    if (!visible.empty()) {
+        target = visible.front();
+        std::cout << " True" << std::endl;
+        return true;
     }
     std::cout << " False" << std::endl;
     return false;
 }
 bool LearningMonster::isAtTarget() {
     std::cout << "Check At Target";
-    if (VectorUtils::vector2Length(targetPos - kinematic.position) < 15) {
+    if (VectorUtils::vector2Length(targetPos - kinematics.getPosition(slot)) < 15) {
         std::cout << " True" << std::endl;
         return true;
     }
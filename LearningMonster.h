@@ -7,6 +7,7 @@
 #include "DecisionTreeNode.h"
 #include "DecisionTreeLearner.h"
 #include "Kinematic.h"
+#include "KinematicStore.h"
 #include "VectorUtils.h"
 #include "SteeringOutput.h"
 #include "Entity.h"
@@ -23,8 +24,10 @@ private:
     sf::CircleShape visionCircle;
     /** The texture of the entity */
     sf::Texture texture;
-    /** The entity's Kinematic */
-    Kinematic kinematic;
+    /** Where the kinematics of every agent live */
+    KinematicStore& kinematics;
+    /** This agent's slot in kinematics */
+    int slot;
     /** The Steering Behaviors the Entity will follow */
     std::vector<std::unique_ptr<SteeringBehavior>> behaviors;
     /** The kinematic struct that entity will aim for */
@@ -51,10 +54,11 @@ public:
      * The entity constructor that creates a generic entity
      * 
      * @oaram id The id of the Entity
-     * @param textureFile The texture the entity will store
+     * @param textureFile The texture the entity will store, empty to load none
      * @param startPos The initial position of the entity
+     * @param kinematics The store to keep the monster's kinematic in
      */
-    LearningMonster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision, const std::string dataPath);
+    LearningMonster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision, const std::string dataPath, KinematicStore& kinematics);
 
     /**
      * The entity deconstructor
@@ -74,8 +78,9 @@ public:
      * Render the entity on the window
      * 
      * @param window The window to render the entity on
+     * @param alpha How far between the previous and current update to draw, 0 to 1
      */
-    void render(sf::RenderWindow& window);
+    void render(sf::RenderWindow& window, float alpha = 1);
 
 
     /**
@@ -1,10 +1,11 @@
 #include "Monster.h"
 #include "SteeringBehavior.h"
 
-Monster::Monster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision) 
-: visionCircle(vision, (int) vision), visionDist(vision), isWandering(false), isChasing(false), isGettingWater(false) {
+Monster::Monster(const int id, const std::string& textureFile, const sf::Vector2f& startPos, const float vision, KinematicStore& kinematics) 
+: visionCircle(vision, (int) vision), kinematics(kinematics), visionDist(vision), isWandering(false), isChasing(false), isGettingWater(false) {
 
-    if (!texture.loadFromFile(textureFile)) {
+    // No texture file means a headless run; the sprite is never drawn
+    if (!textureFile.empty() && !texture.loadFromFile(textureFile)) {
         throw std::runtime_error("Failed to load text: " + textureFile);
     }
 
@@ -16,6 +17,7 @@ Monster::Monster(const int id, const std::string& textureFile, const sf::Vector2
     sprite.setColor(sf::Color::Green);
     
     // Initialize basic stats
+    Kinematic kinematic;
     kinematic.id = id;
 
     kinematic.position = startPos;
@@ -28,6 +30,7 @@ Monster::Monster(const int id, const std::string& textureFile, const sf::Vector2
     kinematic.maxRotation = M_PI / 6;
 
     sprite.setPosition(kinematic.position);
+    slot = kinematics.add(kinematic, KinematicStore::MONSTER);
 
     thirst = 80.0;
 
@@ -112,6 +115,7 @@ Monster::Monster(const int id, const std::string& textureFile, const sf::Vector2
 }
 
 Monster::~Monster() {
+    kinematics.remove(slot);
 }
 
 void Monster::update(float deltaTime) {
@@ -120,6 +124,7 @@ void Monster::update(float deltaTime) {
 
     logState();
 
+    Kinematic kinematic = getKinematic();
     targetKinematic = kinematic;
 
     targetKinematic.position = targetPos;
@@ -139,65 +144,50 @@ void Monster::update(float deltaTime) {
     }
 
 
-    kinematic.position += kinematic.velocity * deltaTime;
-    kinematic.orientation += kinematic.rotation * deltaTime;;
-
-    kinematic.velocity += total.linear * deltaTime;
-    kinematic.rotation += total.angular * deltaTime;
-
-    // Max velocity if it tires to go over
-    if (VectorUtils::vector2Length(kinematic.velocity) > kinematic.maxSpeed) {
-        kinematic.velocity = VectorUtils::normalize(kinematic.velocity) * kinematic.maxSpeed;
-    }
-
-    // Max rotation if it tries to go over
-    if (std::fabs(kinematic.rotation) > kinematic.maxRotation) {
-        kinematic.rotation = (int) std::copysign(1.0f, kinematic.rotation) * kinematic.maxRotation;
-    }
-
-    setPosition(kinematic.position);
-    setOrientation(kinematic.orientation);
-    setKinematic(kinematic);
-
-    visionCircle.setPosition(kinematic.position);
+    // Game integrates every agent at once through the KinematicStore
+    kinematics.setSteering(slot, total);
 
     thirst -= deltaTime;
 }
 
-void Monster::render(sf::RenderWindow& window) {
+void Monster::render(sf::RenderWindow& window, float alpha) {
+    sf::Vector2f position = VectorUtils::lerp(kinematics.getPreviousPosition(slot), kinematics.getPosition(slot), alpha);
+    visionCircle.setPosition(position);
+    sprite.setPosition(position);
+    sprite.setRotation(VectorUtils::radiansToDegrees(VectorUtils::lerpOrientation(kinematics.getPreviousOrientation(slot), kinematics.getOrientation(slot), alpha)));
+
     window.draw(visionCircle);
     window.draw(sprite);
 } 
 
 void Monster::setPosition(const sf::Vector2f &newPosition) {
-    kinematic.position = newPosition;
-    sprite.setPosition(kinematic.position);
+    kinematics.setPosition(slot, newPosition);
+    sprite.setPosition(newPosition);
 }
 
 
 void Monster::setVelocity(const sf::Vector2f &newVelocity) {
-    kinematic.velocity = newVelocity;
+    kinematics.setVelocity(slot, newVelocity);
 }
 
 
 void Monster::setOrientation(const float newOrientation) {
-    kinematic.orientation = newOrientation;
-    // Ensure the angle is in the range 0 to 2p
-    kinematic.orientation = VectorUtils::mapToPiRange(kinematic.orientation);
+    // Ensure the angle is in the range -PI to PI
+    kinematics.setOrientation(slot, newOrientation);
 
     // Set rotation of sprite in degrees
-    float rot_degrees = VectorUtils::radiansToDegrees(kinematic.orientation);
+    float rot_degrees = VectorUtils::radiansToDegrees(kinematics.getOrientation(slot));
     sprite.setRotation(rot_degrees);
 }
 
 
 void Monster::setRotation(const float newRotation) {
-    kinematic.rotation = newRotation;
+    kinematics.setRotation(slot, newRotation);
 }
 
 
 void Monster::setKinematic(Kinematic &kin) {
-    kinematic = kin;
+    kinematics.set(slot, kin);
 }
 
 void Monster::setTargetKinematic(Kinematic &kin) {
@@ -205,7 +195,7 @@ void Monster::setTargetKinematic(Kinematic &kin) {
 }
 
 Kinematic Monster::getKinematic() {
-    return kinematic;
+    return kinematics.get(slot);
 }
 
 void Monster::addSteeringBehavior(std::unique_ptr<SteeringBehavior> behavior) {
@@ -217,7 +207,7 @@ void Monster::clearSteeringBehaviors() {
 }
 
 bool Monster::isAtTarget() {
-    if (VectorUtils::vector2Length(kinematic.position - targetPos) <= 15) {
+    if (VectorUtils::vector2Length(kinematics.getPosition(slot) - targetPos) <= 15) {
         return true;
     }
     return false;
@@ -233,15 +223,15 @@ bool Monster::isThirsty() {
 bool Monster::canSeeWater() {
     // If the Monster already had a target
     if (isGettingWater == true) {
-        if (VectorUtils::vector2Length(targetPos - kinematic.position) < visionDist) {
+        if (VectorUtils::vector2Length(targetPos - kinematics.getPosition(slot)) < visionDist) {
             return true;
         }
     }
 
     isGettingWater = false;
     // If the Monster didn't have water already
-    sf::Vector2f waterPos = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position)->getKinematic().position;
-    if (VectorUtils::vector2Length(waterPos - kinematic.position) < visionDist) {
+    sf::Vector2f waterPos = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot))->getKinematic().position;
+    if (VectorUtils::vector2Length(waterPos - kinematics.getPosition(slot)) < visionDist) {
         targetPos = waterPos;
         return true;
     }
@@ -252,7 +242,7 @@ bool Monster::canSeeWater() {
 bool Monster::canSeeTarget() {
     // If the Monster already had a target
     if (target != nullptr) {
-        if (VectorUtils::vector2Length(targetPos - kinematic.position) < visionDist) {
+        if (VectorUtils::vector2Length(targetPos - kinematics.getPosition(slot)) < visionDist) {
             return true;
         }
         else {
@@ -262,13 +252,10 @@ bool Monster::canSeeTarget() {
     }
 
     // If the Monster didn't have a target already, check to see if it can find one
-    std::vector<Entity*> entities =  Game::getInstance().getEntities();
-    for (auto entity : entities) {
-        // If a target was found
-        if (VectorUtils::vector2Length(entity->getKinematic().position - kinematic.position) < visionDist) {
-            target = entity;
-            return true;
-        }
+    std::vector<Entity*> visible = Game::getInstance().getEntitiesNear(kinematics.getPosition(slot), visionDist);
+    if (!visible.empty()) {
+        target = visible.front();
+        return true;
     }
     return false;
 }
@@ -277,7 +264,7 @@ BehaviorStatus Monster::pathToWater() {
     // If we don't know the current location of water yet
     if (!isGettingWater) {
         isGettingWater = true;
-        targetPos = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position)->getPosition();
+        targetPos = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot))->getPosition();
         clearSteeringBehaviors();
         addSteeringBehavior(std::make_unique<Arrive>(25, 0.5, 10, 50));
         addSteeringBehavior(std::make_unique<Align>(M_PI / 8, 0.5, M_PI / 32, M_PI / 8));
@@ -398,17 +385,11 @@ void Monster::logState() {
     int thirsty = isThirsty() ? 1 : 0;
     int gettingWater = isGettingWater ? 1 : 0;
     int seeWater = 0;
-    sf::Vector2f waterPos = Game::getInstance().getNearestWaterBreadcrumb(kinematic.position)->getKinematic().position;
-    if (VectorUtils::vector2Length(waterPos - kinematic.position) < visionDist) {
+    sf::Vector2f waterPos = Game::getInstance().getNearestWaterBreadcrumb(kinematics.getPosition(slot))->getKinematic().position;
+    if (VectorUtils::vector2Length(waterPos - kinematics.getPosition(slot)) < visionDist) {
         seeWater = 1;
     }
-    int seePlayer = 0;
-    for (auto entity : Game::getInstance().getEntities()) {
-        // If a target was found
-        if (VectorUtils::vector2Length(entity->getKinematic().position - kinematic.position) < visionDist) {
-            seePlayer = 1;
-        }
-    }
+    int seePlayer = Game::getInstance().getEntitiesNear(kinematics.getPosition(slot), visionDist).empty() ? 0 : 1;
     int atTarget = isAtTarget() ? 1 : 0;
     
     std::cout << "LogData: " << thirsty << "," << gettingWater << "," << seeWater << "," << seePlayer << "," << atTarget << "," << currentAction << std::endl;
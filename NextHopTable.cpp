@@ -0,0 +1,186 @@
+#include "NextHopTable.h"
+#include "Graph.h"
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+NextHopTable::NextHopTable() : vertexCount(0), compact(true), dirtyCount(0), directed(false), reverseStale(true) {
+}
+
+bool NextHopTable::build(const Graph& graph, WorkerPool& pool, std::vector<SearchContext>& contexts) {
+    clear();
+    if (graph.getVertexCount() > MAX_VERTICES) return false;
+
+    vertexCount = graph.getVertexCount();
+    compact = vertexCount < NO_SHORT_HOP;
+    directed = graph.isDirectedGraph();
+
+    size_t pairs = (size_t) vertexCount * vertexCount;
+    if (compact) {
+        shortHops.assign(pairs, NO_SHORT_HOP);
+    }
+    else {
+        hops.assign(pairs, -1);
+    }
+    distances.assign(pairs, INF);
+    dirtyRows.assign(vertexCount, 1);
+    dirtyCount = vertexCount;
+
+    refresh(graph, pool, contexts);
+    return true;
+}
+
+void NextHopTable::refresh(const Graph& graph, WorkerPool& pool, std::vector<SearchContext>& contexts) {
+    if (dirtyCount == 0) return;
+
+    std::vector<int> rows;
+    for (int target = 0; target < vertexCount; target++) {
+        if (dirtyRows[target]) rows.push_back(target);
+    }
+
+    prepareReverse(graph);
+    pool.parallelFor(rows.size(), [&](int i, int worker) {
+        computeRow(graph, rows[i], contexts[worker]);
+    });
+    dirtyCount -= rows.size();
+}
+
+void NextHopTable::refreshRow(const Graph& graph, int target, SearchContext& context) {
+    if (target < 0 || target >= vertexCount || !dirtyRows[target]) return;
+
+    prepareReverse(graph);
+    computeRow(graph, target, context);
+    dirtyCount--;
+}
+
+void NextHopTable::prepareReverse(const Graph& graph) {
+    if (!directed || !reverseStale) return;
+
+    reverseOffsets.assign(vertexCount + 1, 0);
+    for (int u = 0; u < vertexCount; u++) {
+        graph.forEachNeighbor(u, [&](int v, float) {
+            if (v >= 0 && v < vertexCount) reverseOffsets[v + 1]++;
+        });
+    }
+    for (int v = 0; v < vertexCount; v++) {
+        reverseOffsets[v + 1] += reverseOffsets[v];
+    }
+
+    reverseSources.resize(reverseOffsets[vertexCount]);
+    reverseWeights.resize(reverseOffsets[vertexCount]);
+    std::vector<int> fill(reverseOffsets.begin(), reverseOffsets.end() - 1);
+    for (int u = 0; u < vertexCount; u++) {
+        graph.forEachNeighbor(u, [&](int v, float weight) {
+            if (v < 0 || v >= vertexCount) return;
+            reverseSources[fill[v]] = u;
+            reverseWeights[fill[v]] = weight;
+            fill[v]++;
+        });
+    }
+
+    reverseStale = false;
+}
+
+void NextHopTable::computeRow(const Graph& graph, int target, SearchContext& context) {
+    size_t row = (size_t) target * vertexCount;
+
+    context.begin(vertexCount);
+    context.relax(target, 0, 0, -1);
+    while (!context.empty()) {
+        auto entry = context.pop();
+        if (context.isStale(entry)) continue;
+
+        int current = entry.second;
+        float distance = context.getDistance(current);
+        auto visit = [&](int neighbor, float weight) {
+            if (neighbor < 0 || neighbor >= vertexCount) return;
+
+            float newDistance = distance + weight;
+            if (newDistance < context.getDistance(neighbor)) {
+                context.relax(neighbor, newDistance, newDistance, current);
+            }
+        };
+
+        // Undirected edges are stored both ways, so the outgoing edges are also the incoming ones
+        if (directed) {
+            for (int e = reverseOffsets[current]; e < reverseOffsets[current + 1]; e++) {
+                visit(reverseSources[e], reverseWeights[e]);
+            }
+        }
+        else {
+            graph.forEachNeighbor(current, visit);
+        }
+    }
+
+    // Searching backward from the target, each vertex's previous link is its step towards it
+    for (int source = 0; source < vertexCount; source++) {
+        distances[row + source] = context.getDistance(source);
+        setHop(row + source, context.getPrevious(source));
+    }
+
+    dirtyRows[target] = 0;
+}
+
+void NextHopTable::setHop(size_t index, int hop) {
+    if (compact) {
+        shortHops[index] = hop == -1 ? NO_SHORT_HOP : hop;
+    }
+    else {
+        hops[index] = hop;
+    }
+}
+
+void NextHopTable::markDirty(int target) {
+    if (dirtyRows[target]) return;
+
+    dirtyRows[target] = 1;
+    dirtyCount++;
+}
+
+void NextHopTable::edgeAdded(int u, int v, float weight) {
+    reverseStale = true;
+    if (u < 0 || u >= vertexCount || v < 0 || v >= vertexCount) return;
+
+    // Only a strictly shorter route through the new edge changes a row
+    for (int target = 0; target < vertexCount; target++) {
+        if (weight + getDistance(v, target) < getDistance(u, target)) markDirty(target);
+    }
+}
+
+void NextHopTable::edgeRemoved(int u, int v) {
+    reverseStale = true;
+    if (u < 0 || u >= vertexCount || v < 0 || v >= vertexCount) return;
+
+    // Rows that never step from u to v keep every distance they had
+    for (int target = 0; target < vertexCount; target++) {
+        if (getNextHop(u, target) == v) markDirty(target);
+    }
+}
+
+int NextHopTable::getDirtyRowCount() const {
+    return dirtyCount;
+}
+
+int NextHopTable::getVertexCount() const {
+    return vertexCount;
+}
+
+void NextHopTable::clear() {
+    vertexCount = 0;
+    compact = true;
+    shortHops.clear();
+    shortHops.shrink_to_fit();
+    hops.clear();
+    hops.shrink_to_fit();
+    distances.clear();
+    distances.shrink_to_fit();
+    dirtyRows.clear();
+    dirtyCount = 0;
+    reverseOffsets.clear();
+    reverseSources.clear();
+    reverseWeights.clear();
+    reverseStale = true;
+}
+
+bool NextHopTable::empty() const {
+    return vertexCount == 0;
+}
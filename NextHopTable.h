@@ -0,0 +1,136 @@
+#ifndef NEXT_HOP_TABLE_H
+#define NEXT_HOP_TABLE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "SearchContext.h"
+#include "WorkerPool.h"
+
+class Graph;
+
+/**
+ * All-pairs first steps and distances for small graphs.
+ *
+ * Row t holds, for every vertex s, the neighbor of s to move to on a shortest route to t and
+ * d(s, t). It is filled by one full Dijkstra from t against the edge directions, so the first
+ * steps are exactly the parent links of t's shortest path tree. Rows are split across a
+ * WorkerPool. Hops are stored as 16-bit ids when the graph has fewer than 65535 vertices,
+ * so a table costs 6 bytes per pair instead of 8.
+ *
+ * Edge changes mark only the rows whose trees they touch as dirty: a removed edge only
+ * matters to rows that step along it, an added one only to rows it gives a shorter route.
+ * Dirty rows are recomputed on their next lookup or by refresh().
+ */
+class NextHopTable {
+private:
+    /** 16-bit value that stands for no hop */
+    static constexpr std::uint16_t NO_SHORT_HOP = 0xFFFF;
+
+    int vertexCount;
+    /** If hops are kept in shortHops rather than hops */
+    bool compact;
+    /** First step from s towards t at [t * vertexCount + s], NO_SHORT_HOP if none */
+    std::vector<std::uint16_t> shortHops;
+    /** Same, -1 if none. Only used for graphs too large for 16-bit ids */
+    std::vector<std::int32_t> hops;
+    /** d(s, t), same layout */
+    std::vector<float> distances;
+    /** Rows that may be out of date. One byte each so workers can clear them concurrently */
+    std::vector<unsigned char> dirtyRows;
+    int dirtyCount;
+
+    /** Incoming edges of directed graphs: the sources and weights of v's are in [reverseOffsets[v], reverseOffsets[v + 1]) */
+    bool directed;
+    bool reverseStale;
+    std::vector<int> reverseOffsets;
+    std::vector<int> reverseSources;
+    std::vector<float> reverseWeights;
+
+    /**
+     * Rebuild the incoming edges of a directed graph if edges changed since the last time
+     */
+    void prepareReverse(const Graph& graph);
+
+    /**
+     * Run a full reverse Dijkstra from target into its row and mark it clean
+     */
+    void computeRow(const Graph& graph, int target, SearchContext& context);
+
+    void setHop(size_t index, int hop);
+
+    void markDirty(int target);
+
+public:
+
+    /** Largest graph build() accepts; the table grows with the square of the vertex count */
+    static constexpr int MAX_VERTICES = 16384;
+
+    NextHopTable();
+
+    /**
+     * Fill every row, one Dijkstra per target spread across the pool
+     *
+     * @param graph The graph to precompute
+     * @param pool Workers to split the targets between
+     * @param contexts One search context per worker
+     * @return false, leaving the table empty, if the graph has more than MAX_VERTICES vertices
+     */
+    bool build(const Graph& graph, WorkerPool& pool, std::vector<SearchContext>& contexts);
+
+    /**
+     * Recompute the dirty rows across the pool
+     */
+    void refresh(const Graph& graph, WorkerPool& pool, std::vector<SearchContext>& contexts);
+
+    /**
+     * Recompute the row of one target if it is dirty
+     */
+    void refreshRow(const Graph& graph, int target, SearchContext& context);
+
+    /**
+     * An edge u -> v of the given weight was added. Dirties the rows it gives a shorter route
+     */
+    void edgeAdded(int u, int v, float weight);
+
+    /**
+     * The edges u -> v were removed. Dirties the rows whose first step from u was v
+     */
+    void edgeRemoved(int u, int v);
+
+    bool isRowDirty(int target) const {
+        return dirtyRows[target] != 0;
+    }
+
+    int getDirtyRowCount() const;
+
+    /**
+     * Get the neighbor of source on a shortest route to target, -1 if unreachable or equal.
+     * Reads the row as it is, so refresh it first if dirty
+     */
+    int getNextHop(int source, int target) const {
+        size_t index = (size_t) target * vertexCount + source;
+        if (compact) {
+            return shortHops[index] == NO_SHORT_HOP ? -1 : shortHops[index];
+        }
+        return hops[index];
+    }
+
+    /**
+     * Get d(source, target), infinity if unreachable
+     */
+    float getDistance(int source, int target) const {
+        return distances[(size_t) target * vertexCount + source];
+    }
+
+    int getVertexCount() const;
+
+    /**
+     * Drop the table
+     */
+    void clear();
+
+    bool empty() const;
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "OccupancyGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+OccupancyGrid::OccupancyGrid(std::string roomPath, float worldWidth, float worldHeight)
+: rows(0), cols(0), worldWidth(worldWidth), worldHeight(worldHeight), version(0) {
+    readRooms(roomPath);
+}
+
+OccupancyGrid::OccupancyGrid(int rows, int cols, float worldWidth, float worldHeight)
+: rows(rows), cols(cols), worldWidth(worldWidth), worldHeight(worldHeight), open(rows * cols, true), version(0) {
+}
+
+void OccupancyGrid::readRooms(std::string roomPath) {
+    std::ifstream file(roomPath);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file: " << roomPath << std::endl;
+        return;
+    }
+
+    // Gather the tiles first, the grid size is the largest row/col seen
+    std::vector<std::vector<int>> tiles;
+    int maxRow = -1;
+    int maxCol = -1;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::string cell;
+        std::vector<int> row;
+
+        while (std::getline(ss, cell, ',')) {
+            try {
+                row.push_back(std::stoi(cell));
+            } catch (const std::exception& e) {
+                std::cerr << "Conversion Error: " << e.what() << " for value: " << cell << std::endl;
+            }
+        }
+
+        if (row.size() >= 3 && row[0] >= 0 && row[1] >= 0) {
+            maxRow = std::max(maxRow, row[0]);
+            maxCol = std::max(maxCol, row[1]);
+            tiles.push_back(row);
+        }
+    }
+
+    file.close();
+
+    // Tiles missing from the file stay walls
+    rows = maxRow + 1;
+    cols = maxCol + 1;
+    open.assign(rows * cols, false);
+    flowFields.clear();
+    version++;
+    for (const auto& tile : tiles) {
+        open[cellId(tile[0], tile[1])] = tile[2] != 0;
+    }
+}
+
+int OccupancyGrid::getRows() const {
+    return rows;
+}
+
+int OccupancyGrid::getCols() const {
+    return cols;
+}
+
+float OccupancyGrid::getCellWidth() const {
+    return cols > 0 ? worldWidth / cols : 0;
+}
+
+float OccupancyGrid::getCellHeight() const {
+    return rows > 0 ? worldHeight / rows : 0;
+}
+
+bool OccupancyGrid::isOpen(int row, int col) const {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return false;
+    return open[cellId(row, col)];
+}
+
+void OccupancyGrid::setOpen(int row, int col, bool isOpen) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) return;
+    open[cellId(row, col)] = isOpen;
+    flowFields.clear();
+    version++;
+}
+
+unsigned long OccupancyGrid::getVersion() const {
+    return version;
+}
+
+int OccupancyGrid::cellId(int row, int col) const {
+    return row * cols + col;
+}
+
+int OccupancyGrid::cellAt(const sf::Vector2f& position) const {
+    int row = (int) (position.y / getCellHeight());
+    int col = (int) (position.x / getCellWidth());
+
+    row = std::min(std::max(row, 0), rows - 1);
+    col = std::min(std::max(col, 0), cols - 1);
+    return cellId(row, col);
+}
+
+sf::Vector2f OccupancyGrid::cellCenter(int cell) const {
+    int row = cell / cols;
+    int col = cell % cols;
+    return sf::Vector2f((col + 0.5f) * getCellWidth(), (row + 0.5f) * getCellHeight());
+}
+
+bool OccupancyGrid::hasLineOfSight(const sf::Vector2f& from, const sf::Vector2f& to, float clearance) const {
+    float cellWidth = getCellWidth();
+    float cellHeight = getCellHeight();
+
+    if (!segmentClear(from.x / cellWidth, from.y / cellHeight, to.x / cellWidth, to.y / cellHeight)) return false;
+    if (clearance <= 0) return true;
+
+    // Shift the segment sideways along its normal, both ways
+    sf::Vector2f direction = to - from;
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+    if (length == 0) return true;
+
+    sf::Vector2f offset(-direction.y / length * clearance, direction.x / length * clearance);
+    for (float side : {1.0f, -1.0f}) {
+        sf::Vector2f a = from + side * offset;
+        sf::Vector2f b = to + side * offset;
+        if (!segmentClear(a.x / cellWidth, a.y / cellHeight, b.x / cellWidth, b.y / cellHeight)) return false;
+    }
+    return true;
+}
+
+bool OccupancyGrid::segmentClear(float x0, float y0, float x1, float y1) const {
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    int col = (int) std::floor(x0);
+    int row = (int) std::floor(y0);
+    int endCol = (int) std::floor(x1);
+    int endRow = (int) std::floor(y1);
+    if (!isOpen(row, col)) return false;
+
+    // Amanatides-Woo traversal: t is the fraction of the segment covered when the next column or row line is crossed
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    int stepCol = dx > 0 ? 1 : -1;
+    int stepRow = dy > 0 ? 1 : -1;
+    float deltaX = dx != 0 ? 1 / std::fabs(dx) : infinity;
+    float deltaY = dy != 0 ? 1 / std::fabs(dy) : infinity;
+    float nextX = dx != 0 ? (dx > 0 ? col + 1 - x0 : x0 - col) * deltaX : infinity;
+    float nextY = dy != 0 ? (dy > 0 ? row + 1 - y0 : y0 - row) * deltaY : infinity;
+
+    while (col != endCol || row != endRow) {
+        // Rounding can leave one axis finished early; only the other one may move then
+        bool moveCol = row == endRow || (col != endCol && nextX < nextY - 1e-6f);
+        bool moveRow = col == endCol || (row != endRow && nextY < nextX - 1e-6f);
+
+        if (!moveCol && !moveRow) {
+            // Straight through a corner: both tiles beside it must be open
+            if (!isOpen(row, col + stepCol) || !isOpen(row + stepRow, col)) return false;
+            moveCol = moveRow = true;
+        }
+
+        if (moveCol) {
+            col += stepCol;
+            nextX += deltaX;
+        }
+        if (moveRow) {
+            row += stepRow;
+            nextY += deltaY;
+        }
+        if (!isOpen(row, col)) return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const FlowField> OccupancyGrid::getFlowField(int goalCell) {
+
+    std::shared_ptr<const FlowField> cached = flowFields.find(goalCell);
+    if (cached) return cached;
+
+    auto field = std::make_shared<FlowField>();
+    field->build(*this, goalCell);
+    flowFields.insert(field);
+
+    return field;
+}
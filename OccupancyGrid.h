@@ -0,0 +1,112 @@
+#ifndef OCCUPANCY_GRID_H
+#define OCCUPANCY_GRID_H
+
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "FlowField.h"
+
+/**
+ * The room/tile grid described by DataFiles/rooms.csv.
+ *
+ * Each csv row is "row,col,value" where a value of 1 is an open tile and 0 is a wall.
+ * The grid is stretched over the world so every tile maps to a rectangle of world space.
+ */
+class OccupancyGrid {
+private:
+    /** Number of tile rows */
+    int rows;
+    /** Number of tile columns */
+    int cols;
+    /** Width of the world the grid covers */
+    float worldWidth;
+    /** Height of the world the grid covers */
+    float worldHeight;
+    /** Open flag of every tile, indexed by cell id */
+    std::vector<bool> open;
+    /** Recently requested flow fields, cleared whenever a tile changes */
+    FlowFieldCache flowFields;
+    /** Bumped whenever a tile changes, so searchers holding a copy of the tiles know to refresh it */
+    unsigned long version;
+
+    /**
+     * Walk every tile a segment in tile units touches, returning false at the first wall
+     */
+    bool segmentClear(float x0, float y0, float x1, float y1) const;
+
+public:
+
+    /**
+     * Load the grid from a rooms csv file
+     *
+     * @param roomPath The csv file to read
+     * @param worldWidth The width of the world the grid covers
+     * @param worldHeight The height of the world the grid covers
+     */
+    OccupancyGrid(std::string roomPath, float worldWidth = 1000, float worldHeight = 800);
+
+    /**
+     * Create a grid with every tile open
+     */
+    OccupancyGrid(int rows, int cols, float worldWidth = 1000, float worldHeight = 800);
+
+    /**
+     * Replace the tiles with the contents of a rooms csv file
+     */
+    void readRooms(std::string roomPath);
+
+    int getRows() const;
+
+    int getCols() const;
+
+    float getCellWidth() const;
+
+    float getCellHeight() const;
+
+    /**
+     * Check if a tile is open. Tiles outside the grid count as walls
+     */
+    bool isOpen(int row, int col) const;
+
+    /**
+     * Open or close a tile
+     */
+    void setOpen(int row, int col, bool isOpen);
+
+    unsigned long getVersion() const;
+
+    /**
+     * Get the cell id of a tile, row major
+     */
+    int cellId(int row, int col) const;
+
+    /**
+     * Get the tile containing a world position, clamped to the grid
+     */
+    int cellAt(const sf::Vector2f& position) const;
+
+    /**
+     * Get the world position of the center of a tile
+     */
+    sf::Vector2f cellCenter(int cell) const;
+
+    /**
+     * Check if a straight segment between two world positions crosses only open tiles.
+     * Passing exactly through a tile corner needs both tiles beside the corner open, the
+     * same rule that stops diagonal moves from cutting wall corners
+     *
+     * @param clearance Also check the two parallel segments this far to either side, for agents with a radius
+     */
+    bool hasLineOfSight(const sf::Vector2f& from, const sf::Vector2f& to, float clearance = 0) const;
+
+    /**
+     * Get the distance and next tile towards goalCell from every tile, shared by every agent
+     * heading there. Cached until a tile is opened, closed or reloaded
+     */
+    std::shared_ptr<const FlowField> getFlowField(int goalCell);
+};
+
+#endif
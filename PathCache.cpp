@@ -0,0 +1,62 @@
+#include "PathCache.h"
+
+PathCache::PathCache(size_t capacity) : capacity(capacity), hits(0), misses(0) {
+}
+
+std::shared_ptr<const Path> PathCache::find(int start, int goal) {
+    auto it = index.find(makeKey(start, goal));
+    if (it == index.end()) {
+        misses++;
+        return nullptr;
+    }
+
+    // Move to the front as the most recently used
+    entries.splice(entries.begin(), entries, it->second);
+    hits++;
+    return it->second->second;
+}
+
+void PathCache::insert(int start, int goal, std::shared_ptr<const Path> path) {
+    if (capacity == 0) return;
+
+    Key key = makeKey(start, goal);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = path;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.emplace_front(key, path);
+    index[key] = entries.begin();
+
+    if (entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void PathCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+void PathCache::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    while (entries.size() > capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+size_t PathCache::size() const {
+    return entries.size();
+}
+
+long PathCache::getHits() const {
+    return hits;
+}
+
+long PathCache::getMisses() const {
+    return misses;
+}
@@ -0,0 +1,84 @@
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * A complete route returned by a Graph search
+ */
+struct Path {
+    /** Every vertex from start to goal inclusive, empty if the goal is unreachable */
+    std::vector<int> vertices;
+    /** Total edge weight of the route */
+    float distance;
+
+    Path() : distance(0) {}
+};
+
+/**
+ * Least-recently-used cache of full paths keyed by (start, goal).
+ *
+ * Paths are shared and immutable, so an agent can keep walking a route it
+ * was handed even after the cache evicts or clears it.
+ */
+class PathCache {
+private:
+    using Key = std::uint64_t;
+    using Entry = std::pair<Key, std::shared_ptr<const Path>>;
+
+    /** Maximum number of paths kept */
+    size_t capacity;
+    /** Entries ordered from most to least recently used */
+    std::list<Entry> entries;
+    /** Lookup from key to its position in entries */
+    std::unordered_map<Key, std::list<Entry>::iterator> index;
+    /** Lookup statistics */
+    long hits;
+    long misses;
+
+    static Key makeKey(int start, int goal) {
+        return (static_cast<Key>(static_cast<std::uint32_t>(start)) << 32) | static_cast<std::uint32_t>(goal);
+    }
+
+public:
+
+    /**
+     * @param capacity The maximum number of paths to keep
+     */
+    PathCache(size_t capacity = 256);
+
+    /**
+     * Look up a cached path and mark it as recently used
+     *
+     * @return the path, or nullptr on a miss
+     */
+    std::shared_ptr<const Path> find(int start, int goal);
+
+    /**
+     * Store a path, evicting the least recently used one when full
+     */
+    void insert(int start, int goal, std::shared_ptr<const Path> path);
+
+    /**
+     * Drop every cached path
+     */
+    void clear();
+
+    /**
+     * Change the capacity, evicting paths if it shrinks
+     */
+    void setCapacity(size_t newCapacity);
+
+    size_t size() const;
+
+    long getHits() const;
+
+    long getMisses() const;
+};
+
+#endif
@@ -0,0 +1,254 @@
+#include "PathRequest.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include "Graph.h"
+
+static const float INF = std::numeric_limits<float>::infinity();
+
+PathRequest::PathRequest(const Graph& graph, int start, int goal)
+: graph(graph), start(start), goal(goal), status(PENDING), context(nullptr), vertexCount(0),
+  compactions(graph.getCompactionCount()), expansions(0), closest(-1), closestEstimate(INF) {
+}
+
+void PathRequest::begin(SearchContext& searchContext) {
+    if (status != PENDING) return;
+
+    // start and goal name other vertices since the graph was compacted
+    if (graph.getCompactionCount() != compactions) {
+        status = CANCELLED;
+        return;
+    }
+
+    context = &searchContext;
+    status = SEARCHING;
+    restart();
+}
+
+void PathRequest::restart() {
+    vertexCount = graph.getVertexCount();
+    closest = -1;
+    closestEstimate = INF;
+
+    if (start < 0 || start >= vertexCount || goal < 0 || goal >= vertexCount) {
+        finish(false);
+        return;
+    }
+
+    context->begin(vertexCount);
+    context->relax(start, 0, graph.heuristic(start, goal), -1);
+}
+
+void PathRequest::finish(bool found) {
+    status = found ? FOUND : UNREACHABLE;
+
+    if (found) {
+        for (int current = goal; current != -1; current = context->getPrevious(current)) {
+            path.vertices.push_back(current);
+        }
+        std::reverse(path.vertices.begin(), path.vertices.end());
+        path.distance = context->getDistance(goal);
+    }
+
+    context = nullptr;
+}
+
+PathRequest::Status PathRequest::step(int maxExpansions) {
+    if (status != SEARCHING) return status;
+
+    if (graph.getCompactionCount() != compactions) {
+        cancel();
+        return status;
+    }
+
+    if (graph.getVertexCount() != vertexCount) {
+        restart();
+        if (status != SEARCHING) return status;
+    }
+
+    int budget = maxExpansions;
+    while (budget > 0) {
+        if (context->empty()) {
+            finish(false);
+            return status;
+        }
+
+        auto entry = context->pop();
+        int currNode = entry.second;
+
+        if (currNode == goal) {
+            finish(true);
+            return status;
+        }
+
+        if (context->isStale(entry)) continue;
+
+        budget--;
+        expansions++;
+
+        float currGScore = context->getDistance(currNode);
+
+        // The key is g + h, so the heuristic comes for free
+        float estimate = entry.first - currGScore;
+        if (estimate < closestEstimate) {
+            closestEstimate = estimate;
+            closest = currNode;
+        }
+
+        graph.forEachNeighbor(currNode, [&](int neighbor, float weight) {
+            if (neighbor < 0 || neighbor >= vertexCount) return;
+
+            float tentative_gScore = currGScore + weight;
+            if (tentative_gScore < context->getDistance(neighbor)) {
+                context->relax(neighbor, tentative_gScore, tentative_gScore + graph.heuristic(neighbor, goal), currNode);
+            }
+        });
+    }
+
+    return status;
+}
+
+void PathRequest::cancel() {
+    if (isDone()) return;
+
+    status = CANCELLED;
+    context = nullptr;
+}
+
+PathRequest::Status PathRequest::getStatus() const {
+    return status;
+}
+
+bool PathRequest::isDone() const {
+    return status == FOUND || status == UNREACHABLE || status == CANCELLED;
+}
+
+int PathRequest::getStart() const {
+    return start;
+}
+
+int PathRequest::getGoal() const {
+    return goal;
+}
+
+long PathRequest::getExpansions() const {
+    return expansions;
+}
+
+const Path& PathRequest::getPath() const {
+    return path;
+}
+
+int PathRequest::getFirstStep() const {
+    return path.vertices.size() > 1 ? path.vertices[1] : -1;
+}
+
+bool PathRequest::getPartialPath(Path& partial) const {
+    if (status == FOUND) {
+        partial = path;
+        return true;
+    }
+
+    partial.vertices.clear();
+    partial.distance = 0;
+    if (status != SEARCHING || closest == -1) return false;
+
+    for (int current = closest; current != -1; current = context->getPrevious(current)) {
+        partial.vertices.push_back(current);
+    }
+    std::reverse(partial.vertices.begin(), partial.vertices.end());
+    partial.distance = context->getDistance(closest);
+
+    return true;
+}
+
+PathScheduler::PathScheduler(int concurrentSearches, int sliceExpansions)
+: contexts(std::max(concurrentSearches, 1)), sliceExpansions(std::max(sliceExpansions, 1)), nextRunning(0) {
+
+    for (int i = (int) contexts.size() - 1; i >= 0; i--) {
+        freeContexts.push_back(i);
+    }
+}
+
+std::shared_ptr<PathRequest> PathScheduler::request(const Graph& graph, int start, int goal) {
+    auto request = std::make_shared<PathRequest>(graph, start, goal);
+    pending.push_back(request);
+    return request;
+}
+
+void PathScheduler::reserve(int vertexCount) {
+    for (int context : freeContexts) {
+        contexts[context].begin(vertexCount);
+    }
+}
+
+void PathScheduler::startPending() {
+    while (!freeContexts.empty() && !pending.empty()) {
+        std::shared_ptr<PathRequest> request = pending.front();
+        pending.pop_front();
+
+        // Nobody is waiting for it any more
+        if (request.use_count() == 1 || request->getStatus() != PathRequest::PENDING) continue;
+
+        int context = freeContexts.back();
+        freeContexts.pop_back();
+        request->begin(contexts[context]);
+        if (request->isDone()) {
+            freeContexts.push_back(context);
+            continue;
+        }
+        running.push_back({request, context});
+    }
+}
+
+long PathScheduler::update(long budgetMicroseconds) {
+    using Clock = std::chrono::steady_clock;
+    auto deadline = Clock::now() + std::chrono::microseconds(budgetMicroseconds);
+    long expanded = 0;
+
+    do {
+        startPending();
+        if (running.empty()) break;
+
+        if (nextRunning >= running.size()) nextRunning = 0;
+        Running& current = running[nextRunning];
+
+        long before = current.request->getExpansions();
+        if (current.request.use_count() == 1) {
+            current.request->cancel();
+        }
+        else {
+            current.request->step(sliceExpansions);
+        }
+        expanded += current.request->getExpansions() - before;
+
+        if (current.request->isDone()) {
+            // Swap the finished request out; whatever lands in its slot runs next
+            freeContexts.push_back(current.context);
+            current = running.back();
+            running.pop_back();
+        }
+        else {
+            nextRunning++;
+        }
+    } while (Clock::now() < deadline);
+
+    return expanded;
+}
+
+size_t PathScheduler::size() const {
+    return pending.size() + running.size();
+}
+
+void PathScheduler::clear() {
+    for (auto& request : pending) {
+        request->cancel();
+    }
+    for (auto& entry : running) {
+        entry.request->cancel();
+        freeContexts.push_back(entry.context);
+    }
+    pending.clear();
+    running.clear();
+    nextRunning = 0;
+}
@@ -0,0 +1,193 @@
+#ifndef PATH_REQUEST_H
+#define PATH_REQUEST_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+#include "PathCache.h"
+#include "SearchContext.h"
+
+class Graph;
+
+/**
+ * An A* query that runs a few expansions at a time, so a long search can be spread over frames.
+ *
+ * The open list and distances live in a SearchContext handed to begin(), and stay there
+ * between step() calls. While searching, getPartialPath() gives the route to the expanded
+ * vertex that looks closest to the goal, so an agent can start moving before the search ends.
+ *
+ * The graph must outlive the request. A change in vertex count restarts the search; edge
+ * changes between steps only affect vertices that have not been expanded yet. Graph::compact()
+ * renumbers the vertices, so a request made before it is cancelled.
+ */
+class PathRequest {
+public:
+    enum Status {
+        /** Waiting for begin() */
+        PENDING,
+        SEARCHING,
+        FOUND,
+        UNREACHABLE,
+        CANCELLED
+    };
+
+private:
+    const Graph& graph;
+    int start;
+    int goal;
+    Status status;
+
+    /** Scratch space of the running search, not owned. Released when the search ends */
+    SearchContext* context;
+    /** Vertex count the search began with */
+    int vertexCount;
+    /** Graph::getCompactionCount when the request was made; start and goal are ids from then */
+    int compactions;
+
+    /** Nodes expanded so far, counting restarts */
+    long expansions;
+    /** Expanded vertex with the smallest heuristic, where getPartialPath leads */
+    int closest;
+    float closestEstimate;
+
+    /** The whole route once FOUND */
+    Path path;
+
+    /**
+     * Queue start in the context, wiping any earlier progress
+     */
+    void restart();
+
+    /**
+     * Store the route if found and let go of the context
+     */
+    void finish(bool found);
+
+public:
+
+    /**
+     * @param graph The graph to search
+     * @param start The vertex the route starts from
+     * @param goal The vertex the route leads to
+     */
+    PathRequest(const Graph& graph, int start, int goal);
+
+    /**
+     * Start searching in context, which must not be used for anything else until the search ends
+     */
+    void begin(SearchContext& context);
+
+    /**
+     * Expand at most maxExpansions nodes. Stale open entries do not count
+     *
+     * @return the status afterwards
+     */
+    Status step(int maxExpansions);
+
+    /**
+     * Stop searching and let go of the context
+     */
+    void cancel();
+
+    Status getStatus() const;
+
+    /**
+     * Check if the request is FOUND, UNREACHABLE or CANCELLED
+     */
+    bool isDone() const;
+
+    int getStart() const;
+
+    int getGoal() const;
+
+    long getExpansions() const;
+
+    /**
+     * The whole route, empty unless FOUND
+     */
+    const Path& getPath() const;
+
+    /**
+     * The vertex to move to from start, -1 unless FOUND with a route of at least one edge
+     */
+    int getFirstStep() const;
+
+    /**
+     * Fill path with the best route known so far: the whole route once FOUND, or while
+     * searching the route to the expanded vertex the heuristic puts closest to the goal
+     *
+     * @return if path holds at least the start
+     */
+    bool getPartialPath(Path& path) const;
+};
+
+/**
+ * Spreads PathRequests across frames under a time budget.
+ *
+ * Requests start in the order they were made, a few at a time, each in one of the
+ * scheduler's own search contexts. update() steps the running requests round robin in
+ * small slices until the budget is used up. A request nobody else holds any more is dropped.
+ */
+class PathScheduler {
+private:
+    struct Running {
+        std::shared_ptr<PathRequest> request;
+        int context;
+    };
+
+    /** One context per request that may run at once */
+    std::vector<SearchContext> contexts;
+    /** Indices of contexts no request is using */
+    std::vector<int> freeContexts;
+    /** Requests not started yet, oldest first */
+    std::deque<std::shared_ptr<PathRequest>> pending;
+    /** Requests searching in a context */
+    std::vector<Running> running;
+    /** Expansions per step() call between clock checks */
+    int sliceExpansions;
+    /** Index into running where the next update resumes */
+    size_t nextRunning;
+
+    /**
+     * Move pending requests into free contexts
+     */
+    void startPending();
+
+public:
+
+    /**
+     * @param concurrentSearches The number of requests searching at once, one context each
+     * @param sliceExpansions Expansions per step between clock checks
+     */
+    PathScheduler(int concurrentSearches = 4, int sliceExpansions = 128);
+
+    /**
+     * Queue an A* search from start to goal. Poll the returned request for its status
+     */
+    std::shared_ptr<PathRequest> request(const Graph& graph, int start, int goal);
+
+    /**
+     * Grow the idle contexts to vertexCount now, instead of in the frame the first searches start
+     */
+    void reserve(int vertexCount);
+
+    /**
+     * Step running requests until budgetMicroseconds have passed or nothing is left to do.
+     * At least one slice runs if any request is waiting
+     *
+     * @return the number of nodes expanded
+     */
+    long update(long budgetMicroseconds);
+
+    /**
+     * Number of requests waiting or searching
+     */
+    size_t size() const;
+
+    /**
+     * Cancel every request
+     */
+    void clear();
+};
+
+#endif
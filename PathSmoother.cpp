@@ -0,0 +1,61 @@
+#include "PathSmoother.h"
+#include <cmath>
+#include "Graph.h"
+#include "OccupancyGrid.h"
+
+PathSmoother::PathSmoother(const OccupancyGrid& grid, float clearance) : grid(grid), clearance(clearance) {
+}
+
+void PathSmoother::setClearance(float newClearance) {
+    clearance = newClearance;
+}
+
+float PathSmoother::getClearance() const {
+    return clearance;
+}
+
+void PathSmoother::smooth(const std::vector<sf::Vector2f>& points, std::vector<sf::Vector2f>& waypoints) const {
+    waypoints.clear();
+    if (points.empty()) return;
+
+    waypoints.push_back(points.front());
+
+    // Pull the string tight from the last kept point until the next point is out of sight,
+    // then keep the point before it. A route edge that is itself blocked is kept as is
+    size_t anchor = 0;
+    for (size_t i = 2; i < points.size(); i++) {
+        if (!grid.hasLineOfSight(points[anchor], points[i], clearance)) {
+            waypoints.push_back(points[i - 1]);
+            anchor = i - 1;
+        }
+    }
+
+    if (points.size() > 1) waypoints.push_back(points.back());
+}
+
+void PathSmoother::smooth(const Graph& graph, const Path& path, std::vector<sf::Vector2f>& waypoints) const {
+    std::vector<sf::Vector2f> points;
+    points.reserve(path.vertices.size());
+    for (int v : path.vertices) {
+        points.push_back(graph.getPosition(v));
+    }
+    smooth(points, waypoints);
+}
+
+void PathSmoother::smoothCells(const Path& path, std::vector<sf::Vector2f>& waypoints) const {
+    std::vector<sf::Vector2f> points;
+    points.reserve(path.vertices.size());
+    for (int cell : path.vertices) {
+        points.push_back(grid.cellCenter(cell));
+    }
+    smooth(points, waypoints);
+}
+
+float PathSmoother::length(const std::vector<sf::Vector2f>& points) {
+    float total = 0;
+    for (size_t i = 1; i < points.size(); i++) {
+        sf::Vector2f d = points[i] - points[i - 1];
+        total += std::sqrt(d.x * d.x + d.y * d.y);
+    }
+    return total;
+}
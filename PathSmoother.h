@@ -0,0 +1,60 @@
+#ifndef PATH_SMOOTHER_H
+#define PATH_SMOOTHER_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include "PathCache.h"
+
+class Graph;
+class OccupancyGrid;
+
+/**
+ * String pulling for routes returned by the searches.
+ *
+ * Walks the route and keeps only the points where the straight line from the last kept
+ * point would run into a wall of the OccupancyGrid. Agents then steer straight across open
+ * rooms instead of zig-zagging from vertex to vertex, and arrive at far fewer targets.
+ */
+class PathSmoother {
+private:
+    const OccupancyGrid& grid;
+    /** Distance every shortcut keeps from walls, for agents with a radius */
+    float clearance;
+
+public:
+
+    /**
+     * @param grid The walls to check shortcuts against. It must outlive the smoother
+     * @param clearance Distance every shortcut keeps from walls
+     */
+    PathSmoother(const OccupancyGrid& grid, float clearance = 0);
+
+    void setClearance(float clearance);
+
+    float getClearance() const;
+
+    /**
+     * Reduce a polyline to the waypoints that have to be kept. The first and last points are always kept
+     *
+     * @param points The route, start first
+     * @param waypoints Filled with the kept points
+     */
+    void smooth(const std::vector<sf::Vector2f>& points, std::vector<sf::Vector2f>& waypoints) const;
+
+    /**
+     * Smooth a Graph route, using the vertex positions
+     */
+    void smooth(const Graph& graph, const Path& path, std::vector<sf::Vector2f>& waypoints) const;
+
+    /**
+     * Smooth a route of grid cell ids, such as from JumpPointSearch or a grid FlowField, through the cell centers
+     */
+    void smoothCells(const Path& path, std::vector<sf::Vector2f>& waypoints) const;
+
+    /**
+     * Total length of a polyline
+     */
+    static float length(const std::vector<sf::Vector2f>& points);
+};
+
+#endif
@@ -0,0 +1,177 @@
+#include "SearchContext.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+SearchContext::SearchContext(QueueType queueType) : queueType(queueType), activeType(queueType), generation(0), lastPopped(0), radixSize(0) {
+}
+
+void SearchContext::setQueueType(QueueType type) {
+    queueType = type;
+}
+
+SearchContext::QueueType SearchContext::getQueueType() const {
+    return queueType;
+}
+
+void SearchContext::begin(int vertexCount) {
+
+    if ((int) stamps.size() < vertexCount) {
+        stamps.resize(vertexCount, 0);
+        distances.resize(vertexCount);
+        keys.resize(vertexCount);
+        previous.resize(vertexCount);
+        heapSlot.resize(vertexCount);
+    }
+
+    openList.clear();
+    indexedHeap.clear();
+    for (auto& bucket : radixBuckets) {
+        bucket.clear();
+    }
+    radixSize = 0;
+    lastPopped = 0;
+    activeType = queueType;
+    generation++;
+
+    // On wrap-around old stamps could match again, so wipe them once
+    if (generation == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        generation = 1;
+    }
+}
+
+std::uint32_t SearchContext::keyBits(float key) {
+    // Non-negative floats order the same way as their bit patterns read as unsigned integers
+    std::uint32_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+int SearchContext::radixBucket(std::uint32_t bits) const {
+    return bits == lastPopped ? 0 : 32 - __builtin_clz(bits ^ lastPopped);
+}
+
+void SearchContext::spillRadix() {
+    openList.clear();
+    for (auto& bucket : radixBuckets) {
+        openList.insert(openList.end(), bucket.begin(), bucket.end());
+        bucket.clear();
+    }
+    radixSize = 0;
+    std::make_heap(openList.begin(), openList.end(), std::greater<>());
+    activeType = BINARY_HEAP;
+}
+
+void SearchContext::siftUp(int slot) {
+    int v = indexedHeap[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (keys[indexedHeap[parent]] <= keys[v]) break;
+        indexedHeap[slot] = indexedHeap[parent];
+        heapSlot[indexedHeap[slot]] = slot;
+        slot = parent;
+    }
+    indexedHeap[slot] = v;
+    heapSlot[v] = slot;
+}
+
+void SearchContext::siftDown(int slot) {
+    int v = indexedHeap[slot];
+    int size = indexedHeap.size();
+    while (true) {
+        int child = 2 * slot + 1;
+        if (child >= size) break;
+        if (child + 1 < size && keys[indexedHeap[child + 1]] < keys[indexedHeap[child]]) child++;
+        if (keys[v] <= keys[indexedHeap[child]]) break;
+        indexedHeap[slot] = indexedHeap[child];
+        heapSlot[indexedHeap[slot]] = slot;
+        slot = child;
+    }
+    indexedHeap[slot] = v;
+    heapSlot[v] = slot;
+}
+
+void SearchContext::relax(int v, float distance, float key, int prev) {
+    bool seen = stamps[v] == generation;
+
+    stamps[v] = generation;
+    distances[v] = distance;
+    keys[v] = key;
+    previous[v] = prev;
+
+    // Clamping a key that dropped below the last pop would let pop() return it after larger
+    // ones, and A* could stop at the goal early. Only inconsistent heuristics get here
+    if (activeType == RADIX_HEAP && keyBits(key) < lastPopped) {
+        spillRadix();
+    }
+
+    switch (activeType) {
+        case INDEXED_HEAP:
+            // Decrease-key in place while v is still open, otherwise (re)insert it
+            if (seen && heapSlot[v] != -1) {
+                siftUp(heapSlot[v]);
+                siftDown(heapSlot[v]);
+            }
+            else {
+                indexedHeap.push_back(v);
+                siftUp(indexedHeap.size() - 1);
+            }
+            break;
+
+        case RADIX_HEAP:
+            radixBuckets[radixBucket(keyBits(key))].emplace_back(key, v);
+            radixSize++;
+            break;
+
+        default:
+            openList.emplace_back(key, v);
+            std::push_heap(openList.begin(), openList.end(), std::greater<>());
+            break;
+    }
+}
+
+std::pair<float, int> SearchContext::pop() {
+    switch (activeType) {
+        case INDEXED_HEAP: {
+            int v = indexedHeap[0];
+            indexedHeap[0] = indexedHeap.back();
+            indexedHeap.pop_back();
+            if (!indexedHeap.empty()) siftDown(0);
+            heapSlot[v] = -1;
+            return {keys[v], v};
+        }
+
+        case RADIX_HEAP: {
+            if (radixBuckets[0].empty()) {
+                // Move up to the smallest key in the first non-empty bucket and spread that bucket out.
+                // Every entry lands in a lower bucket, so each entry is moved at most 32 times
+                int i = 1;
+                while (radixBuckets[i].empty()) i++;
+
+                std::uint32_t smallest = UINT32_MAX;
+                for (const auto& entry : radixBuckets[i]) {
+                    smallest = std::min(smallest, keyBits(entry.first));
+                }
+                lastPopped = smallest;
+
+                for (const auto& entry : radixBuckets[i]) {
+                    radixBuckets[radixBucket(keyBits(entry.first))].push_back(entry);
+                }
+                radixBuckets[i].clear();
+            }
+
+            std::pair<float, int> top = radixBuckets[0].back();
+            radixBuckets[0].pop_back();
+            radixSize--;
+            return top;
+        }
+
+        default: {
+            std::pop_heap(openList.begin(), openList.end(), std::greater<>());
+            std::pair<float, int> top = openList.back();
+            openList.pop_back();
+            return top;
+        }
+    }
+}
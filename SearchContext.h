@@ -0,0 +1,151 @@
+#ifndef SEARCH_CONTEXT_H
+#define SEARCH_CONTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <limits>
+
+/**
+ * Reusable per-vertex scratch space for Graph searches.
+ *
+ * Every array is indexed by vertex id and tagged with the generation that last wrote it,
+ * so starting a new search is O(1) instead of resetting V entries. Keep one context per
+ * thread and reuse it; once the arrays have grown to the graph size no search allocates.
+ *
+ * The open list is a binary heap with lazy deletion by default. An indexed heap with
+ * decrease-key keeps at most one entry per vertex, and a monotone radix heap makes pops
+ * cheaper when keys never drop below the last key popped, as in Dijkstra or in A* with a
+ * consistent heuristic. The radix heap buckets keys by their float bit patterns, so it
+ * works for integer weights and fractional ones alike. A key below the last pop, from an
+ * inconsistent heuristic, moves the open entries into the binary heap for the rest of that
+ * search, so pop() always returns the smallest key.
+ */
+class SearchContext {
+public:
+    enum QueueType {
+        BINARY_HEAP,
+        INDEXED_HEAP,
+        RADIX_HEAP
+    };
+
+private:
+    QueueType queueType;
+    /** Open list of the search running now: queueType, or BINARY_HEAP after a radix heap spilled */
+    QueueType activeType;
+
+    /** Generation of the search currently running */
+    unsigned int generation;
+    /** Generation that last wrote each vertex's entries */
+    std::vector<unsigned int> stamps;
+    /** Best known cost from the start */
+    std::vector<float> distances;
+    /** Priority the vertex was last queued with */
+    std::vector<float> keys;
+    /** Previous vertex on the best known path */
+    std::vector<int> previous;
+    /** Binary min-heap of (key, vertex) open entries */
+    std::vector<std::pair<float, int>> openList;
+
+    /** Indexed min-heap of open vertices, ordered by keys */
+    std::vector<int> indexedHeap;
+    /** Slot of each vertex in indexedHeap, -1 once popped. Only valid for vertices stamped this search */
+    std::vector<int> heapSlot;
+
+    /** Radix heap buckets. Bucket i holds keys whose highest bit differing from lastPopped is bit i - 1 */
+    std::vector<std::pair<float, int>> radixBuckets[33];
+    /** Bit pattern of the last key popped; every open key is at least this */
+    std::uint32_t lastPopped;
+    /** Entries across all radix buckets */
+    std::size_t radixSize;
+
+    static std::uint32_t keyBits(float key);
+
+    int radixBucket(std::uint32_t bits) const;
+
+    /**
+     * Move every radix entry into the binary heap and keep using it until the next begin()
+     */
+    void spillRadix();
+
+    void siftUp(int slot);
+    void siftDown(int slot);
+
+public:
+
+    /**
+     * @param queueType The open list to use
+     */
+    SearchContext(QueueType queueType = BINARY_HEAP);
+
+    /**
+     * Switch the open list. Takes effect from the next begin()
+     */
+    void setQueueType(QueueType type);
+
+    QueueType getQueueType() const;
+
+    /**
+     * Start a new search over a graph with vertexCount vertices
+     *
+     * @param vertexCount The number of vertex ids the search may touch
+     */
+    void begin(int vertexCount);
+
+    /**
+     * Get the best known cost to a vertex, infinity if unseen this search
+     */
+    float getDistance(int v) const {
+        return stamps[v] == generation ? distances[v] : std::numeric_limits<float>::infinity();
+    }
+
+    /**
+     * Get the key a vertex was last queued with, infinity if unseen this search
+     */
+    float getKey(int v) const {
+        return stamps[v] == generation ? keys[v] : std::numeric_limits<float>::infinity();
+    }
+
+    /**
+     * Get the previous vertex on the best known path, -1 if none
+     */
+    int getPrevious(int v) const {
+        return stamps[v] == generation ? previous[v] : -1;
+    }
+
+    /**
+     * Record a better path to v and queue it with the given key
+     *
+     * @param v The vertex that improved
+     * @param distance The new cost from the start
+     * @param key The priority to queue v with
+     * @param prev The vertex v was reached from
+     */
+    void relax(int v, float distance, float key, int prev);
+
+    /**
+     * Check if the open list is empty
+     */
+    bool empty() const {
+        switch (activeType) {
+            case INDEXED_HEAP: return indexedHeap.empty();
+            case RADIX_HEAP: return radixSize == 0;
+            default: return openList.empty();
+        }
+    }
+
+    /**
+     * Pop the open entry with the smallest key
+     */
+    std::pair<float, int> pop();
+
+    /**
+     * Check if a popped entry was superseded by a later relax
+     */
+    bool isStale(const std::pair<float, int>& entry) const {
+        return entry.first > getKey(entry.second);
+    }
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "SpatialHash.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+/** Cells past this many from the origin share the edge cell, so cell arithmetic cannot overflow */
+static const int CELL_LIMIT = 1 << 24;
+
+SpatialHash::SpatialHash(float cellSize) : cellSize(cellSize), mask(0), minCellX(0), minCellY(0), maxCellX(-1), maxCellY(-1) {
+}
+
+void SpatialHash::setCellSize(float newCellSize) {
+    if (newCellSize > 0) cellSize = newCellSize;
+}
+
+float SpatialHash::getCellSize() const {
+    return cellSize;
+}
+
+int SpatialHash::cellCoordinate(float value) const {
+    float cell = std::floor(value / cellSize);
+
+    // Written so NaN also lands on the edge
+    if (!(cell > -CELL_LIMIT)) return -CELL_LIMIT;
+    if (cell > CELL_LIMIT) return CELL_LIMIT;
+    return (int) cell;
+}
+
+uint32_t SpatialHash::bucketOf(int x, int y) const {
+    return ((uint32_t) x * 73856093u ^ (uint32_t) y * 19349663u) & mask;
+}
+
+template <typename Visitor>
+void SpatialHash::visitCell(int x, int y, Visitor&& visit) const {
+    uint32_t bucket = bucketOf(x, y);
+    for (int e = bucketStart[bucket]; e < bucketStart[bucket + 1]; e++) {
+        // Other cells can hash to the same bucket
+        if (cellX[e] == x && cellY[e] == y) visit(e);
+    }
+}
+
+void SpatialHash::rebuild(const KinematicStore& kinematics) {
+    const float* storeX = kinematics.getPositionX();
+    const float* storeY = kinematics.getPositionY();
+    const KinematicStore::Kind* storeKinds = kinematics.getKinds();
+    int count = kinematics.size();
+
+    int occupied = 0;
+    for (int i = 0; i < count; i++) {
+        if (storeKinds[i] != KinematicStore::FREE) occupied++;
+    }
+
+    // At least two buckets per agent keeps collisions between nearby cells rare
+    uint32_t buckets = 16;
+    while (buckets < 2 * (uint32_t) occupied) buckets *= 2;
+    mask = buckets - 1;
+
+    bucketStart.assign(buckets + 1, 0);
+    slots.resize(occupied);
+    positionX.resize(occupied);
+    positionY.resize(occupied);
+    cellX.resize(occupied);
+    cellY.resize(occupied);
+    kinds.resize(occupied);
+
+    minCellX = minCellY = INT_MAX;
+    maxCellX = maxCellY = INT_MIN;
+    for (int i = 0; i < count; i++) {
+        if (storeKinds[i] == KinematicStore::FREE) continue;
+
+        int x = cellCoordinate(storeX[i]);
+        int y = cellCoordinate(storeY[i]);
+        minCellX = std::min(minCellX, x);
+        minCellY = std::min(minCellY, y);
+        maxCellX = std::max(maxCellX, x);
+        maxCellY = std::max(maxCellY, y);
+        bucketStart[bucketOf(x, y)]++;
+    }
+
+    // Counting sort: turn the counts into starts, advance each start while placing the
+    // entries in slot order, then shift the starts back into place
+    int start = 0;
+    for (uint32_t b = 0; b < buckets; b++) {
+        int size = bucketStart[b];
+        bucketStart[b] = start;
+        start += size;
+    }
+    for (int i = 0; i < count; i++) {
+        if (storeKinds[i] == KinematicStore::FREE) continue;
+
+        int x = cellCoordinate(storeX[i]);
+        int y = cellCoordinate(storeY[i]);
+        int e = bucketStart[bucketOf(x, y)]++;
+        slots[e] = i;
+        positionX[e] = storeX[i];
+        positionY[e] = storeY[i];
+        cellX[e] = x;
+        cellY[e] = y;
+        kinds[e] = storeKinds[i];
+    }
+    for (uint32_t b = buckets; b > 0; b--) {
+        bucketStart[b] = bucketStart[b - 1];
+    }
+    bucketStart[0] = 0;
+}
+
+void SpatialHash::queryRadius(const sf::Vector2f& center, float radius, KinematicStore::Kind kind, std::vector<int>& out) const {
+    out.clear();
+    if (slots.empty() || !(radius > 0)) return;
+
+    float radiusSquared = radius * radius;
+    auto check = [&](int e) {
+        float dx = positionX[e] - center.x;
+        float dy = positionY[e] - center.y;
+        if (kinds[e] == kind && dx * dx + dy * dy < radiusSquared) out.push_back(slots[e]);
+    };
+
+    // Only the occupied part of the square around the circle
+    int left = std::max(cellCoordinate(center.x - radius), minCellX);
+    int right = std::min(cellCoordinate(center.x + radius), maxCellX);
+    int top = std::max(cellCoordinate(center.y - radius), minCellY);
+    int bottom = std::min(cellCoordinate(center.y + radius), maxCellY);
+    if (left > right || top > bottom) return;
+
+    // A radius covering more cells than there are agents is cheaper as a plain scan
+    if ((long long) (right - left + 1) * (bottom - top + 1) > (long long) slots.size()) {
+        for (int e = 0; e < (int) slots.size(); e++) {
+            check(e);
+        }
+    }
+    else {
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                visitCell(x, y, check);
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end());
+}
+
+void SpatialHash::kNearest(const sf::Vector2f& center, int k, KinematicStore::Kind kind, std::vector<int>& out, int exclude) const {
+    out.clear();
+    if (slots.empty() || k <= 0) return;
+
+    // Max-heap of the k closest (squared distance, slot) seen so far
+    std::priority_queue<std::pair<float, int>> closest;
+    auto consider = [&](int e) {
+        if (kinds[e] != kind || slots[e] == exclude) return;
+
+        float dx = positionX[e] - center.x;
+        float dy = positionY[e] - center.y;
+        std::pair<float, int> entry = {dx * dx + dy * dy, slots[e]};
+
+        if ((int) closest.size() < k) {
+            closest.push(entry);
+        }
+        else if (entry < closest.top()) {
+            closest.pop();
+            closest.push(entry);
+        }
+    };
+
+    int column = cellCoordinate(center.x);
+    int row = cellCoordinate(center.y);
+
+    // Rings of cells outward from the point, starting at the first one that reaches an agent
+    int first = std::max({0, minCellX - column, column - maxCellX, minCellY - row, row - maxCellY});
+    long long cellsVisited = 0;
+    for (int r = first; ; r++) {
+        int left = column - r, right = column + r;
+        int top = row - r, bottom = row + r;
+
+        int fromX = std::max(left, minCellX), toX = std::min(right, maxCellX);
+        int fromY = std::max(top + 1, minCellY), toY = std::min(bottom - 1, maxCellY);
+        long long ringCells = 0;
+        if (fromX <= toX) ringCells += (top >= minCellY) + (bottom <= maxCellY && r > 0);
+        ringCells *= toX - fromX + 1;
+        if (fromY <= toY) ringCells += (long long) (toY - fromY + 1) * ((left >= minCellX) + (right <= maxCellX && r > 0));
+
+        // Sparse agents far apart would make the rings mostly empty; scan them all instead
+        cellsVisited += ringCells;
+        if (cellsVisited > (long long) slots.size() + 64) {
+            closest = {};
+            for (int e = 0; e < (int) slots.size(); e++) {
+                consider(e);
+            }
+            break;
+        }
+
+        for (int x = fromX; x <= toX; x++) {
+            if (top >= minCellY) visitCell(x, top, consider);
+            if (bottom <= maxCellY && r > 0) visitCell(x, bottom, consider);
+        }
+        for (int y = fromY; y <= toY; y++) {
+            if (left >= minCellX) visitCell(left, y, consider);
+            if (right <= maxCellX && r > 0) visitCell(right, y, consider);
+        }
+
+        // Every occupied cell has been searched
+        if (left <= minCellX && right >= maxCellX && top <= minCellY && bottom >= maxCellY) break;
+
+        // Nothing outside the searched square is closer than its nearest edge
+        float bound = std::min({center.x - left * cellSize, (right + 1) * cellSize - center.x,
+                                center.y - top * cellSize, (bottom + 1) * cellSize - center.y});
+        bound = std::max(bound, 0.0f);
+        if ((int) closest.size() == k && closest.top().first <= bound * bound) break;
+    }
+
+    out.resize(closest.size());
+    for (int i = (int) out.size() - 1; i >= 0; i--) {
+        out[i] = closest.top().second;
+        closest.pop();
+    }
+}
+
+int SpatialHash::size() const {
+    return (int) slots.size();
+}
@@ -0,0 +1,86 @@
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "KinematicStore.h"
+
+/**
+ * Uniform spatial hash over the agents of a KinematicStore, for neighbor and vision queries.
+ *
+ * The world is cut into square cells and every cell hashes to a bucket, so agents anywhere in
+ * the plane are covered without knowing the bounds up front. rebuild() snapshots every agent
+ * once per tick with a counting sort into flat arrays; a query then only looks at the cells its
+ * radius overlaps, so it costs about the number of agents near the point instead of the
+ * population. Queries see positions as of the last rebuild.
+ */
+class SpatialHash {
+private:
+    float cellSize;
+    /** Bucket count minus one; the bucket count is a power of two */
+    uint32_t mask;
+
+    /** Entries of bucket b are [bucketStart[b], bucketStart[b + 1]), in slot order */
+    std::vector<int> bucketStart;
+    std::vector<int> slots;
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<int> cellX;
+    std::vector<int> cellY;
+    std::vector<KinematicStore::Kind> kinds;
+
+    /** Cells holding at least one entry, so ring searches know when to stop */
+    int minCellX, minCellY, maxCellX, maxCellY;
+
+    int cellCoordinate(float value) const;
+
+    uint32_t bucketOf(int x, int y) const;
+
+    /**
+     * Call visit(entry) for every entry in cell (x, y)
+     */
+    template <typename Visitor>
+    void visitCell(int x, int y, Visitor&& visit) const;
+
+public:
+
+    /**
+     * @param cellSize Side of a cell in world units. About the most common query radius works best
+     */
+    SpatialHash(float cellSize = 100);
+
+    /**
+     * Set the cell side. Takes effect at the next rebuild()
+     */
+    void setCellSize(float newCellSize);
+
+    float getCellSize() const;
+
+    /**
+     * Replace the contents with every occupied slot of a store
+     */
+    void rebuild(const KinematicStore& kinematics);
+
+    /**
+     * Slots of one kind strictly within radius of a point
+     *
+     * @param out Cleared, then filled with the slots found in ascending order
+     */
+    void queryRadius(const sf::Vector2f& center, float radius, KinematicStore::Kind kind, std::vector<int>& out) const;
+
+    /**
+     * Up to k slots of one kind closest to a point
+     *
+     * @param exclude A slot to leave out, such as the asking agent's own, or -1
+     * @param out Cleared, then filled with the slots found, closest first
+     */
+    void kNearest(const sf::Vector2f& center, int k, KinematicStore::Kind kind, std::vector<int>& out, int exclude = -1) const;
+
+    /**
+     * Number of slots indexed by the last rebuild
+     */
+    int size() const;
+};
+
+#endif
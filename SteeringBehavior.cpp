@@ -1,5 +1,6 @@
 #include "SteeringBehavior.h"
 #include "Entity.h"
+#include <algorithm>
 
 
 PositionMatching::PositionMatching(const float maxAccel, const float time) {
@@ -258,6 +259,11 @@ Flocking::Flocking(const float turnFact, const float visRange, const float prote
 }
 
 SteeringOutput Flocking::update(Kinematic &playerKinematic, const Kinematic &targetKinematic) {
+    Game& game = Game::getInstance();
+    return steer(playerKinematic, game.getKinematics(), &game.getAgentGrid());
+}
+
+SteeringOutput Flocking::steer(const Kinematic &playerKinematic, const KinematicStore &kinematics, const SpatialHash* grid) {
     SteeringOutput steeringOutput;
 
     float xPosAvg = 0.0;
@@ -268,18 +274,37 @@ SteeringOutput Flocking::update(Kinematic &playerKinematic, const Kinematic &tar
     float closeDx = 0.0;
     float closeDy = 0.0;
 
-    std::vector<Entity*> entities = Game::getInstance().getEntities();
+    // Stream over the positions and velocities of every agent instead of chasing entity pointers
+    const float* positionX = kinematics.getPositionX();
+    const float* positionY = kinematics.getPositionY();
+    const float* velocityX = kinematics.getVelocityX();
+    const float* velocityY = kinematics.getVelocityY();
+    const int* ids = kinematics.getIds();
+    const KinematicStore::Kind* kinds = kinematics.getKinds();
+
+    // Only boids within range count, so the grid narrows the scan to the nearby cells. Its
+    // results come in slot order, so the sums below add up exactly as in the full scan
+    int count;
+    const int* candidates = nullptr;
+    if (grid) {
+        grid->queryRadius(playerKinematic.position, std::max(visualRange, protectedRange), KinematicStore::ENTITY, neighbors);
+        candidates = neighbors.data();
+        count = (int) neighbors.size();
+    }
+    else {
+        count = kinematics.size();
+    }
 
     // For every other boid in the flock...
-    for (auto entity : entities) {
-        if (entity->getKinematic().id == playerKinematic.id) {
+    for (int n = 0; n < count; n++) {
+        int i = candidates ? candidates[n] : n;
+        if (kinds[i] != KinematicStore::ENTITY || ids[i] == playerKinematic.id) {
             continue;
         }
-        printf("%d\n", entity->getKinematic().id);
 
         // Compute differences in x and y coordinates
-        float dx = playerKinematic.position.x - entity->getKinematic().position.x;
-        float dy = playerKinematic.position.y - entity->getKinematic().position.y;
+        float dx = playerKinematic.position.x - positionX[i];
+        float dy = playerKinematic.position.y - positionY[i];
 
         // Check if the other boid is within visual range
         if (std::fabs(dx) < visualRange and std::fabs(dy) < visualRange) {
@@ -293,10 +318,10 @@ SteeringOutput Flocking::update(Kinematic &playerKinematic, const Kinematic &tar
             }
             // Otherwise, apply alignment and cohesion
             else if (squaredDistance < visualRange * visualRange) {
-                xPosAvg += entity->getKinematic().position.x;
-                yPosAvg += entity->getKinematic().position.y;
-                xVelAvg += entity->getKinematic().velocity.x;
-                yVelAvg += entity->getKinematic().velocity.y;
+                xPosAvg += positionX[i];
+                yPosAvg += positionY[i];
+                xVelAvg += velocityX[i];
+                yVelAvg += velocityY[i];
                 neighboringEntities += 1;
             }
         }
@@ -339,7 +364,6 @@ SteeringOutput Flocking::update(Kinematic &playerKinematic, const Kinematic &tar
     }
 
     steeringOutput.linear = sf::Vector2f(ax, ay);
-    printf("%f %f\n", steeringOutput.linear.x, steeringOutput.linear.y);
     return steeringOutput;
 
 }
\ No newline at end of file
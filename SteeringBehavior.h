@@ -190,6 +190,11 @@ public:
 
 class Flocking : public SteeringBehavior {
 
+private:
+
+    /** Reused for the neighbor query of every update */
+    std::vector<int> neighbors;
+
 public:
 
     float turnFactor;
@@ -218,6 +223,15 @@ public:
     Flocking(const float turnFact, const float visRange, const float protectRange, const float centerFact, const float avoidFact, const float matchFact, const float maxAccel);
 
     SteeringOutput update(Kinematic &playerKinematic, const Kinematic &targetKinematic) override;
+
+    /**
+     * Flock with the entities of a store
+     *
+     * @param playerKinematic The boid to steer
+     * @param kinematics Where every other boid lives
+     * @param grid The store's agents bucketed by position, or null to scan every slot
+     */
+    SteeringOutput steer(const Kinematic &playerKinematic, const KinematicStore &kinematics, const SpatialHash* grid);
 };
 
 #endif // End STEERING_BEHVIOR_H
\ No newline at end of file
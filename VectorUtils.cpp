@@ -38,9 +38,25 @@ float VectorUtils::radiansToDegrees(const float radians) {
     return radians * (180 / M_PI);
 }
 
+sf::Vector2f VectorUtils::lerp(const sf::Vector2f& from, const sf::Vector2f& to, const float t) {
+    return from + (to - from) * t;
+}
+
+float VectorUtils::lerpOrientation(const float from, const float to, const float t) {
+    return mapToPiRange(from + mapToPiRange(to - from) * t);
+}
+
+std::default_random_engine& VectorUtils::randomEngine() {
+    static std::default_random_engine engine(std::random_device{}());
+    return engine;
+}
+
+void VectorUtils::seedRandom(unsigned seed) {
+    randomEngine().seed(seed);
+}
+
 float VectorUtils::randomBinomial() {
-    std::random_device rd;  // Random device to seed the random engine
-    std::default_random_engine generator(rd());  // Initialize the generator with the seed
+    std::default_random_engine& generator = randomEngine();
 
     int n = 10; 
     double p = 0.5;  // Probability of success (50% success rate)
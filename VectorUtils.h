@@ -52,8 +52,39 @@ public:
      */
     static float radiansToDegrees(const float radians);
 
+    /**
+     * Linear interpolation between two vectors
+     *
+     * @param from the value at t = 0
+     * @param to the value at t = 1
+     * @param t how far from from to to
+     * @return the interpolated vector
+     */
+    static sf::Vector2f lerp(const sf::Vector2f& from, const sf::Vector2f& to, const float t);
+
+    /**
+     * Interpolate between two orientations the short way around the circle
+     *
+     * @param from the orientation at t = 0
+     * @param to the orientation at t = 1
+     * @param t how far from from to to
+     * @return the interpolated orientation
+     */
+    static float lerpOrientation(const float from, const float to, const float t);
+
     static float randomBinomial();
 
+    /**
+     * The engine behind randomBinomial and the game's other random draws. Seeded from
+     * std::random_device unless seedRandom was called
+     */
+    static std::default_random_engine& randomEngine();
+
+    /**
+     * Reseed randomEngine so a simulation replays the same way
+     */
+    static void seedRandom(unsigned seed);
+
 };
 
 #endif // VECTOR_UTIL_H
\ No newline at end of file
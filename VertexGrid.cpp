@@ -0,0 +1,235 @@
+#include "VertexGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+VertexGrid::VertexGrid() : minX(0), minY(0), cellSize(1), columns(0), rows(0), count(0), rebuildAt(0) {
+}
+
+void VertexGrid::rebuild() {
+
+    // Bounds of everything currently indexed
+    float lowX = INFINITY, lowY = INFINITY, highX = -INFINITY, highY = -INFINITY;
+    for (int id = 0; id < (int) cellOf.size(); id++) {
+        if (cellOf[id] == -1) continue;
+        lowX = std::min(lowX, positions[id].x);
+        lowY = std::min(lowY, positions[id].y);
+        highX = std::max(highX, positions[id].x);
+        highY = std::max(highY, positions[id].y);
+    }
+
+    cellHead.clear();
+    rebuildAt = std::max(8, count * 2);
+    if (count == 0) {
+        columns = rows = 0;
+        return;
+    }
+
+    // About two vertices per cell over the occupied area. The second term keeps
+    // vertices that all lie on one line from producing a huge number of cells
+    float width = highX - lowX;
+    float height = highY - lowY;
+    float target = std::max(1, count / 2);
+    cellSize = std::max({std::sqrt(width * height / target), std::max(width, height) / target, 1e-3f});
+
+    // Pad each side by half the extent so vertices added nearby do not force another rebuild
+    float padX = std::max(width / 2, cellSize);
+    float padY = std::max(height / 2, cellSize);
+    minX = lowX - padX;
+    minY = lowY - padY;
+    columns = (int) std::ceil((width + 2 * padX) / cellSize);
+    rows = (int) std::ceil((height + 2 * padY) / cellSize);
+    cellHead.assign((size_t) columns * rows, -1);
+
+    for (int id = 0; id < (int) cellOf.size(); id++) {
+        if (cellOf[id] == -1) continue;
+        link(id);
+    }
+}
+
+void VertexGrid::link(int id) {
+    int cell = cellRow(positions[id].y) * columns + cellColumn(positions[id].x);
+    cellOf[id] = cell;
+    previousInCell[id] = -1;
+    nextInCell[id] = cellHead[cell];
+    if (cellHead[cell] != -1) previousInCell[cellHead[cell]] = id;
+    cellHead[cell] = id;
+}
+
+int VertexGrid::cellColumn(float x) const {
+    int column = (int) std::floor((x - minX) / cellSize);
+    return std::clamp(column, 0, columns - 1);
+}
+
+int VertexGrid::cellRow(float y) const {
+    int row = (int) std::floor((y - minY) / cellSize);
+    return std::clamp(row, 0, rows - 1);
+}
+
+bool VertexGrid::inBounds(const sf::Vector2f& position) const {
+    return position.x >= minX && position.x < minX + columns * cellSize &&
+           position.y >= minY && position.y < minY + rows * cellSize;
+}
+
+template <typename Visitor>
+float VertexGrid::visitRing(const sf::Vector2f& point, int column, int row, int r, Visitor&& visit) const {
+
+    int left = column - r, right = column + r;
+    int top = row - r, bottom = row + r;
+
+    auto visitCell = [&](int c, int rw) {
+        if (c < 0 || c >= columns || rw < 0 || rw >= rows) return;
+        for (int id = cellHead[rw * columns + c]; id != -1; id = nextInCell[id]) {
+            visit(id);
+        }
+    };
+
+    if (r == 0) {
+        visitCell(column, row);
+    }
+    else {
+        for (int c = left; c <= right; c++) {
+            visitCell(c, top);
+            visitCell(c, bottom);
+        }
+        for (int rw = top + 1; rw < bottom; rw++) {
+            visitCell(left, rw);
+            visitCell(right, rw);
+        }
+    }
+
+    // Any cell not searched yet lies past one of the box edges that still has grid beyond it
+    float bound = INFINITY;
+    if (left > 0) bound = std::min(bound, point.x - (minX + left * cellSize));
+    if (right < columns - 1) bound = std::min(bound, minX + (right + 1) * cellSize - point.x);
+    if (top > 0) bound = std::min(bound, point.y - (minY + top * cellSize));
+    if (bottom < rows - 1) bound = std::min(bound, minY + (bottom + 1) * cellSize - point.y);
+
+    return bound == INFINITY ? -1 : std::max(bound, 0.0f);
+}
+
+void VertexGrid::insert(int id, const sf::Vector2f& position) {
+    if (id < 0) return;
+
+    if (id >= (int) cellOf.size()) {
+        cellOf.resize(id + 1, -1);
+        positions.resize(id + 1);
+        nextInCell.resize(id + 1);
+        previousInCell.resize(id + 1);
+    }
+
+    remove(id);
+    positions[id] = position;
+    count++;
+
+    if (count > rebuildAt || !inBounds(position)) {
+        // Any non -1 value marks the id as indexed; rebuild assigns the real cell
+        cellOf[id] = 0;
+        rebuild();
+        return;
+    }
+
+    link(id);
+}
+
+void VertexGrid::assign(const std::vector<sf::Vector2f>& vertexPositions) {
+    positions = vertexPositions;
+    cellOf.assign(positions.size(), 0);
+    nextInCell.resize(positions.size());
+    previousInCell.resize(positions.size());
+    count = positions.size();
+    rebuild();
+}
+
+void VertexGrid::remove(int id) {
+    if (id < 0 || id >= (int) cellOf.size() || cellOf[id] == -1) return;
+
+    int next = nextInCell[id];
+    int previous = previousInCell[id];
+    if (previous != -1) nextInCell[previous] = next;
+    else cellHead[cellOf[id]] = next;
+    if (next != -1) previousInCell[next] = previous;
+
+    cellOf[id] = -1;
+    count--;
+}
+
+void VertexGrid::clear() {
+    positions.clear();
+    cellOf.clear();
+    cellHead.clear();
+    nextInCell.clear();
+    previousInCell.clear();
+    columns = rows = 0;
+    count = 0;
+    rebuildAt = 0;
+}
+
+int VertexGrid::nearest(const sf::Vector2f& point) const {
+    if (count == 0) return -1;
+
+    int column = cellColumn(point.x);
+    int row = cellRow(point.y);
+
+    int best = -1;
+    float bestSquared = INFINITY;
+
+    for (int r = 0; ; r++) {
+        float bound = visitRing(point, column, row, r, [&](int id) {
+            float dx = positions[id].x - point.x;
+            float dy = positions[id].y - point.y;
+            float squared = dx * dx + dy * dy;
+
+            // Ties go to the lowest id, as the old linear scan did
+            if (squared < bestSquared || (squared == bestSquared && id < best)) {
+                bestSquared = squared;
+                best = id;
+            }
+        });
+
+        if (bound < 0 || (best != -1 && bestSquared < bound * bound)) break;
+    }
+
+    return best;
+}
+
+std::vector<int> VertexGrid::kNearest(const sf::Vector2f& point, int k) const {
+    std::vector<int> result;
+    if (count == 0 || k <= 0) return result;
+
+    int column = cellColumn(point.x);
+    int row = cellRow(point.y);
+
+    // Max-heap of the k closest (squared distance, id) seen so far
+    std::priority_queue<std::pair<float, int>> closest;
+
+    for (int r = 0; ; r++) {
+        float bound = visitRing(point, column, row, r, [&](int id) {
+            float dx = positions[id].x - point.x;
+            float dy = positions[id].y - point.y;
+            std::pair<float, int> entry = {dx * dx + dy * dy, id};
+
+            if ((int) closest.size() < k) {
+                closest.push(entry);
+            }
+            else if (entry < closest.top()) {
+                closest.pop();
+                closest.push(entry);
+            }
+        });
+
+        if (bound < 0 || ((int) closest.size() == k && closest.top().first <= bound * bound)) break;
+    }
+
+    result.resize(closest.size());
+    for (int i = (int) result.size() - 1; i >= 0; i--) {
+        result[i] = closest.top().second;
+        closest.pop();
+    }
+    return result;
+}
+
+int VertexGrid::size() const {
+    return count;
+}
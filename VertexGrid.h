@@ -0,0 +1,103 @@
+#ifndef VERTEX_GRID_H
+#define VERTEX_GRID_H
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+/**
+ * Uniform bucket grid over vertex positions for nearest-vertex lookups.
+ *
+ * Cells are sized so each holds about two vertices, and the grid is rebuilt
+ * whenever the vertex count doubles or a vertex lands outside its bounds, so
+ * inserts stay amortized O(1). Queries search rings of cells outward from the
+ * query point and stop once no unvisited cell can hold anything closer, which
+ * is O(1) on average for evenly spread vertices.
+ */
+class VertexGrid {
+private:
+    /** World position of every id ever inserted */
+    std::vector<sf::Vector2f> positions;
+    /** Cell currently holding each id, -1 if the id is not indexed */
+    std::vector<int> cellOf;
+    /** Doubly linked list of the ids in each cell, threaded through flat arrays so rebuilds do not allocate per cell */
+    std::vector<int> cellHead;
+    std::vector<int> nextInCell;
+    std::vector<int> previousInCell;
+
+    /** World bounds covered by the cells */
+    float minX, minY;
+    float cellSize;
+    int columns, rows;
+
+    /** Number of ids currently indexed */
+    int count;
+    /** Count at which the grid is rebuilt with smaller cells */
+    int rebuildAt;
+
+    /**
+     * Resize the cells to fit every indexed id, with room to grow around them
+     */
+    void rebuild();
+
+    /**
+     * Link an id into the cell covering its position
+     */
+    void link(int id);
+
+    int cellColumn(float x) const;
+    int cellRow(float y) const;
+
+    bool inBounds(const sf::Vector2f& position) const;
+
+    /**
+     * Visit the ids in every cell of ring r around (column, row), then return the smallest
+     * distance from point to any cell outside the rings searched so far, negative if none are left
+     */
+    template <typename Visitor>
+    float visitRing(const sf::Vector2f& point, int column, int row, int r, Visitor&& visit) const;
+
+public:
+
+    VertexGrid();
+
+    /**
+     * Index a vertex, or move it if the id is already indexed
+     *
+     * @param id The vertex id
+     * @param position The vertex position in world space
+     */
+    void insert(int id, const sf::Vector2f& position);
+
+    /**
+     * Replace the contents with vertices 0 to positions.size() - 1 in one rebuild
+     */
+    void assign(const std::vector<sf::Vector2f>& positions);
+
+    /**
+     * Stop returning a vertex from queries
+     */
+    void remove(int id);
+
+    /**
+     * Drop every vertex
+     */
+    void clear();
+
+    /**
+     * Get the indexed vertex closest to point
+     *
+     * @return its id, or -1 if the grid is empty
+     */
+    int nearest(const sf::Vector2f& point) const;
+
+    /**
+     * Get up to k indexed vertices closest to point
+     *
+     * @return their ids, closest first
+     */
+    std::vector<int> kNearest(const sf::Vector2f& point, int k) const;
+
+    int size() const;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int workerCount)
+: jobId(0), activeThreads(0), stopping(false), task(nullptr), taskCount(0), chunkSize(1), nextIndex(0) {
+
+    if (workerCount <= 0) workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int worker = 1; worker < workerCount; worker++) {
+        threads.emplace_back(&WorkerPool::threadLoop, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::runChunks(int worker) {
+    while (true) {
+        int begin = nextIndex.fetch_add(chunkSize);
+        if (begin >= taskCount) return;
+
+        int end = std::min(begin + chunkSize, taskCount);
+        for (int i = begin; i < end; i++) {
+            (*task)(i, worker);
+        }
+    }
+}
+
+void WorkerPool::threadLoop(int worker) {
+    unsigned long seenJob = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [&] { return stopping || jobId != seenJob; });
+            if (stopping) return;
+            seenJob = jobId;
+        }
+
+        runChunks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            activeThreads--;
+        }
+        jobDone.notify_one();
+    }
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int, int)>& job) {
+    if (count <= 0) return;
+
+    // Small batches are not worth a wakeup
+    if (threads.empty() || count == 1) {
+        for (int i = 0; i < count; i++) job(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &job;
+        taskCount = count;
+        // Several chunks per worker keeps them balanced when some queries run long
+        chunkSize = std::max(1, count / (getWorkerCount() * 8));
+        nextIndex = 0;
+        activeThreads = threads.size();
+        jobId++;
+    }
+    jobReady.notify_all();
+
+    runChunks(0);
+
+    // Every background thread must leave runChunks before job goes out of scope
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [&] { return activeThreads == 0; });
+    task = nullptr;
+}
+
+int WorkerPool::getWorkerCount() const {
+    return threads.size() + 1;
+}
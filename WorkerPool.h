@@ -0,0 +1,77 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of persistent threads that split index ranges between them.
+ *
+ * The calling thread joins in as worker 0, so a pool of N workers starts N - 1
+ * threads. Threads sleep between jobs, so handing out a batch costs one wakeup
+ * instead of spawning threads every frame.
+ */
+class WorkerPool {
+private:
+    /** Background threads, workers 1 to N - 1 */
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    /** Wakes background threads when a job is posted or the pool shuts down */
+    std::condition_variable jobReady;
+    /** Wakes the caller when the last background thread leaves a job */
+    std::condition_variable jobDone;
+
+    /** Incremented for every job so sleeping threads can tell a new one arrived */
+    unsigned long jobId;
+    /** Background threads still inside the current job */
+    int activeThreads;
+    bool stopping;
+
+    /** Current job: task(index, worker) for every index below taskCount */
+    const std::function<void(int, int)>* task;
+    int taskCount;
+    int chunkSize;
+    /** Next index that has not been claimed */
+    std::atomic<int> nextIndex;
+
+    /**
+     * Claim and run chunks of the current job until none are left
+     */
+    void runChunks(int worker);
+
+    /**
+     * Loop run by every background thread
+     */
+    void threadLoop(int worker);
+
+public:
+
+    /**
+     * @param workerCount Total workers including the caller; 0 uses every hardware thread
+     */
+    WorkerPool(int workerCount = 0);
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Run task(index, worker) for every index in [0, count) and wait for all of them.
+     * worker is in [0, getWorkerCount()) and no two calls with the same worker run at once,
+     * so it can index per-worker scratch space. Not reentrant
+     *
+     * @param count The number of indices to run
+     * @param task The work for one index
+     */
+    void parallelFor(int count, const std::function<void(int, int)>& task);
+
+    int getWorkerCount() const;
+};
+
+#endif
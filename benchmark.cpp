@@ -0,0 +1,1239 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "ContractionHierarchy.h"
+#include "DStarLite.h"
+#include "Graph.h"
+#include "HierarchicalGraph.h"
+#include "JumpPointSearch.h"
+#include "KinematicStore.h"
+#include "OccupancyGrid.h"
+#include "PathRequest.h"
+#include "PathSmoother.h"
+#include "SpatialHash.h"
+#include "SteeringBehavior.h"
+#include "VectorUtils.h"
+
+// Standalone benchmark harness. Run as ./benchmark [suite] [size] [queries]
+
+using Clock = std::chrono::steady_clock;
+
+// Pick reproducible random (start, goal) pairs
+static std::vector<std::pair<int, int>> makeQueries(int vertexCount, int queryCount, unsigned seed) {
+    std::srand(seed);
+    std::vector<std::pair<int, int>> queries;
+    for (int i = 0; i < queryCount; i++) {
+        queries.push_back({std::rand() % vertexCount, std::rand() % vertexCount});
+    }
+    return queries;
+}
+
+// Square lattice of side x side vertices spread over a worldSize square, 4-connected.
+// maxDetour > 1 scales each edge by a random factor in [1, maxDetour) to mimic winding corridors
+static void makeLatticeGraph(Graph& graph, int side, float worldSize, int maxDetour = 1) {
+    float spacing = worldSize / side;
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            graph.addVertex((col + 0.5f) * spacing, (row + 0.5f) * spacing);
+        }
+    }
+    for (int row = 0; row < side; row++) {
+        for (int col = 0; col < side; col++) {
+            int id = row * side + col;
+            if (col + 1 < side) graph.addEdge(id, id + 1, spacing * (1 + std::rand() % maxDetour));
+            if (row + 1 < side) graph.addEdge(id, id + side, spacing * (1 + std::rand() % maxDetour));
+        }
+    }
+}
+
+// One vertex per tile of grid, with directed edges to its 4 or 8 open neighbors that do not cut wall corners
+static void makeGridGraph(Graph& graph, const OccupancyGrid& grid, bool diagonal) {
+    int rows = grid.getRows(), cols = grid.getCols();
+    for (int cell = 0; cell < rows * cols; cell++) {
+        sf::Vector2f center = grid.cellCenter(cell);
+        graph.addVertex(center.x, center.y);
+    }
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            if (!grid.isOpen(row, col)) continue;
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    if ((dr == 0 && dc == 0) || !grid.isOpen(row + dr, col + dc)) continue;
+                    if (dr != 0 && dc != 0 && (!diagonal || !grid.isOpen(row + dr, col) || !grid.isOpen(row, col + dc))) continue;
+
+                    int from = grid.cellId(row, col), to = grid.cellId(row + dr, col + dc);
+                    graph.addEdge(from, to, Graph::euclideanHeuristic(grid.cellCenter(from), grid.cellCenter(to)));
+                }
+            }
+        }
+    }
+}
+
+// Run every query through the given search and report queries per second
+static double timeQueries(const std::string& label, const std::vector<std::pair<int, int>>& queries, const std::function<int(int, int)>& search) {
+    long checksum = 0;
+    auto begin = Clock::now();
+    for (const auto& [start, goal] : queries) {
+        checksum += search(start, goal);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    double qps = queries.size() / seconds;
+
+    std::cout << "  " << label << ": " << qps << " queries/s (checksum " << checksum << ")" << std::endl;
+    return qps;
+}
+
+// Adjacency list vs. finalized CSR adjacency
+static void benchmarkCsr(int size, int queryCount) {
+    std::cout << "[csr] " << size << " vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph(size);
+    auto queries = makeQueries(size, queryCount, 2);
+
+    double listDijkstra = timeQueries("adjList dijkstra", queries, [&](int s, int g) { return graph.dijkstra(s, g); });
+    double listAstar = timeQueries("adjList astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    graph.finalize();
+
+    double csrDijkstra = timeQueries("csr dijkstra", queries, [&](int s, int g) { return graph.dijkstra(s, g); });
+    double csrAstar = timeQueries("csr astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    std::cout << "  speedup dijkstra x" << csrDijkstra / listDijkstra << ", astar x" << csrAstar / listAstar << std::endl;
+}
+
+// Agents walking whole routes: re-querying astar at every waypoint vs. one cached full path
+static void benchmarkPathCache(int size, int queryCount) {
+    std::cout << "[pathcache] " << size << " vertices, " << queryCount << " routes" << std::endl;
+
+    std::srand(1);
+    Graph graph(size);
+    graph.finalize();
+    auto queries = makeQueries(size, queryCount, 2);
+
+    // Each agent steps to the next waypoint and asks again, as the first-step API forces
+    long searches = 0;
+    auto begin = Clock::now();
+    for (const auto& [start, goal] : queries) {
+        int current = start;
+        while (current != goal && current != -1) {
+            current = graph.astar(current, goal);
+            searches++;
+        }
+    }
+    double perWaypoint = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  astar per waypoint: " << perWaypoint << " s (" << searches << " searches)" << std::endl;
+
+    // Each agent requests its route once and walks it; the second lap is served from the cache
+    graph.setPathCacheCapacity(queryCount);
+    long waypoints = 0;
+    begin = Clock::now();
+    for (int lap = 0; lap < 2; lap++) {
+        for (const auto& [start, goal] : queries) {
+            std::shared_ptr<const Path> path = graph.getPath(start, goal);
+            waypoints += path->vertices.size();
+        }
+    }
+    double cached = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  cached full paths, 2 laps: " << cached << " s (" << waypoints << " waypoints, "
+              << graph.getPathCache().getHits() << " hits, " << graph.getPathCache().getMisses() << " misses)" << std::endl;
+
+    std::cout << "  speedup x" << perWaypoint / cached << std::endl;
+}
+
+// Flat astar vs. HPA* first steps on a lattice clustered by a 20x20 tile grid
+static void benchmarkHierarchical(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[hpa] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000);
+    graph.finalize();
+    OccupancyGrid grid(20, 20, 1000, 1000);
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    auto begin = Clock::now();
+    HierarchicalGraph hierarchy(graph, grid, 4);
+    double buildTime = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  build: " << buildTime << " s, " << hierarchy.getClusterCount() << " clusters, "
+              << hierarchy.getEntranceCount() << " entrances" << std::endl;
+
+    double flat = timeQueries("flat astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    double hpa = timeQueries("hpa first step", queries, [&](int s, int g) { return hierarchy.astar(s, g); });
+
+    std::cout << "  speedup x" << hpa / flat << std::endl;
+}
+
+// Euclidean astar vs. ALT landmarks on a lattice whose weights exceed straight-line distance
+static void benchmarkLandmarks(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[alt] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    double euclidean = timeQueries("euclidean astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    auto begin = Clock::now();
+    graph.buildLandmarks(8);
+    double buildTime = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    graph.saveLandmarks("/tmp/benchmark_landmarks.csv");
+    begin = Clock::now();
+    bool loaded = graph.loadLandmarks("/tmp/benchmark_landmarks.csv");
+    double loadTime = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  8 landmarks: build " << buildTime << " s, reload " << loadTime << " s" << (loaded ? "" : " (failed)") << std::endl;
+
+    double alt = timeQueries("alt astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    std::cout << "  speedup x" << alt / euclidean << std::endl;
+}
+
+// One astar call per agent on the main thread vs. the same requests fanned out by batchQuery
+static void benchmarkBatch(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[batch] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    double serial = timeQueries("serial astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    int hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> workerCounts;
+    for (int workers = 1; workers < hardware; workers *= 2) workerCounts.push_back(workers);
+    workerCounts.push_back(hardware);
+
+    for (int workers : workerCounts) {
+        // Start the threads before timing
+        graph.setWorkerCount(workers);
+        graph.batchQuery({});
+
+        auto begin = Clock::now();
+        std::vector<int> steps = graph.batchQuery(queries);
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        long checksum = 0;
+        for (int step : steps) checksum += step;
+        std::cout << "  batchQuery, " << workers << " workers: " << queries.size() / seconds
+                  << " queries/s (checksum " << checksum << "), speedup x" << queries.size() / seconds / serial << std::endl;
+    }
+}
+
+// Linear scan over every vertex, as getClosestVertex did before the vertex grid
+static int scanClosestVertex(const Graph& graph, float x, float y) {
+    int closest = 0;
+    float shortestDistance = std::numeric_limits<float>::infinity();
+    for (int v = 0; v < graph.getVertexCount(); v++) {
+        sf::Vector2f position = graph.getPosition(v);
+        float distance = std::sqrt(std::pow(position.x - x, 2) + std::pow(position.y - y, 2));
+        if (distance < shortestDistance) {
+            shortestDistance = distance;
+            closest = v;
+        }
+    }
+    return closest;
+}
+
+// Linear scan vs. the vertex grid for snapping points onto graphs of 1k, 10k and 100k vertices
+static void benchmarkClosest(int size, int queryCount) {
+    for (int vertexCount : {1000, 10000, 100000}) {
+        std::cout << "[closest] " << vertexCount << " vertices, " << queryCount << " points" << std::endl;
+
+        std::srand(1);
+        Graph graph;
+        for (int v = 0; v < vertexCount; v++) {
+            graph.addVertex(std::rand() % 100000 / 100.0f, std::rand() % 100000 / 100.0f);
+        }
+
+        // Reuse the (start, goal) generator for integer world coordinates
+        auto points = makeQueries(1000, queryCount, 2);
+
+        int mismatches = 0;
+        for (const auto& [x, y] : points) {
+            if (graph.getClosestVertex(x, y).id != scanClosestVertex(graph, x, y)) mismatches++;
+        }
+        std::cout << "  nearest mismatches: " << mismatches << std::endl;
+
+        double scan = timeQueries("linear scan", points, [&](int x, int y) { return scanClosestVertex(graph, x, y); });
+        double grid = timeQueries("vertex grid", points, [&](int x, int y) { return graph.getClosestVertex(x, y).id; });
+        timeQueries("vertex grid, 8 nearest", points, [&](int x, int y) { return graph.getClosestVertices(x, y, 8).back(); });
+
+        std::cout << "  speedup x" << grid / scan << std::endl;
+    }
+}
+
+// Parsing the csv files vs. mapping the binary graph file for the same lattice
+static void benchmarkBinary(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[binary] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph source;
+    makeLatticeGraph(source, side, 1000, 4);
+
+    // Write the lattice in the DataFiles csv layout, one row per undirected edge
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string vertexPath = (directory / "benchmark_vertices.csv").string();
+    std::string edgePath = (directory / "benchmark_edges.csv").string();
+    std::string binaryPath = (directory / "benchmark_graph.bin").string();
+    {
+        std::ofstream vertexFile(vertexPath);
+        std::ofstream edgeFile(edgePath);
+        for (int u = 0; u < source.getVertexCount(); u++) {
+            sf::Vector2f position = source.getPosition(u);
+            vertexFile << u << "," << position.x << "," << position.y << "\n";
+            source.forEachNeighbor(u, [&](int v, float weight) {
+                if (u < v) edgeFile << u << "," << v << "," << weight << "\n";
+            });
+        }
+    }
+
+    auto begin = Clock::now();
+    Graph csv(vertexPath, edgePath);
+    csv.finalize();
+    double csvSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  csv load + finalize: " << csvSeconds * 1000 << " ms" << std::endl;
+
+    csv.saveBinary(binaryPath);
+
+    Graph binary;
+    begin = Clock::now();
+    binary.loadBinary(binaryPath);
+    double binarySeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  binary load: " << binarySeconds * 1000 << " ms (" << binary.getEdgeCount() << " adjacency entries)" << std::endl;
+
+    auto queries = makeQueries(side * side, queryCount, 2);
+    timeQueries("csv astar", queries, [&](int s, int g) { return csv.astar(s, g); });
+    timeQueries("binary astar", queries, [&](int s, int g) { return binary.astar(s, g); });
+
+    std::cout << "  speedup x" << csvSeconds / binarySeconds << std::endl;
+
+    std::filesystem::remove(vertexPath);
+    std::filesystem::remove(edgePath);
+    std::filesystem::remove(binaryPath);
+}
+
+// Doors closing and reopening under many routed agents: full findPath replans vs. D* Lite repairs
+static void benchmarkDStarLite(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    int rounds = 20;
+    std::cout << "[dstar] " << side * side << " lattice vertices, " << queryCount << " agents, " << rounds << " door toggles" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    std::vector<std::unique_ptr<DStarLite>> replanners;
+    for (const auto& [start, goal] : queries) {
+        replanners.push_back(std::make_unique<DStarLite>(graph, start, goal));
+        replanners.back()->plan();
+    }
+
+    // Each door is an edge on some agent's current route, closed one round and reopened the next
+    std::vector<std::tuple<int, int, float>> doors;
+    SearchContext context;
+    for (int i = 0; i < rounds / 2; i++) {
+        Path path;
+        const auto& [start, goal] = queries[std::rand() % queries.size()];
+        if (!graph.findPath(start, goal, path, context) || path.vertices.size() < 2) continue;
+
+        int hop = std::rand() % (path.vertices.size() - 1);
+        int u = path.vertices[hop], v = path.vertices[hop + 1];
+        float weight = std::numeric_limits<float>::infinity();
+        graph.forEachNeighbor(u, [&](int neighbor, float w) { if (neighbor == v) weight = std::min(weight, w); });
+        doors.push_back({u, v, weight});
+    }
+
+    double fullSeconds = 0, repairSeconds = 0;
+    double fullChecksum = 0, repairChecksum = 0;
+    for (const auto& [u, v, weight] : doors) {
+        for (int open = 0; open < 2; open++) {
+            if (open) graph.addEdge(u, v, weight);
+            else graph.removeEdge(u, v);
+
+            // Every agent plans again from scratch, as a removal forces today
+            auto begin = Clock::now();
+            for (const auto& [start, goal] : queries) {
+                Path path;
+                graph.findPath(start, goal, path, context);
+                fullChecksum += path.distance;
+            }
+            fullSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+
+            begin = Clock::now();
+            for (auto& replanner : replanners) {
+                replanner->plan();
+                repairChecksum += replanner->getDistance() == std::numeric_limits<float>::infinity() ? 0 : replanner->getDistance();
+            }
+            repairSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        }
+    }
+
+    std::cout << "  findPath replans: " << fullSeconds * 1000 << " ms (distance checksum " << fullChecksum << ")" << std::endl;
+    std::cout << "  D* Lite repairs: " << repairSeconds * 1000 << " ms (distance checksum " << repairChecksum << ")" << std::endl;
+    std::cout << "  speedup x" << fullSeconds / repairSeconds << std::endl;
+}
+
+// Many agents heading to one goal: a findPath each vs. walking one shared flow field
+static void benchmarkFlowField(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[flow] " << side * side << " lattice vertices, " << queryCount << " agents sharing a goal" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+
+    // Every agent starts somewhere random and heads for the same water vertex
+    auto queries = makeQueries(side * side, queryCount, 2);
+    int goal = queries[0].second;
+
+    SearchContext context;
+    double searchChecksum = 0;
+    auto begin = Clock::now();
+    for (const auto& [start, unused] : queries) {
+        Path path;
+        graph.findPath(start, goal, path, context);
+        searchChecksum += path.distance;
+    }
+    double perAgent = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  findPath per agent: " << perAgent * 1000 << " ms (distance checksum " << searchChecksum << ")" << std::endl;
+
+    double fieldChecksum = 0;
+    begin = Clock::now();
+    for (const auto& [start, unused] : queries) {
+        Path path;
+        graph.getFlowField(goal)->getPath(start, path);
+        fieldChecksum += path.distance;
+    }
+    double shared = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  shared flow field: " << shared * 1000 << " ms (distance checksum " << fieldChecksum << ", "
+              << graph.getFlowFieldCache().getMisses() << " builds)" << std::endl;
+
+    std::cout << "  speedup x" << perAgent / shared << std::endl;
+
+    // The same mode over the rooms grid
+    OccupancyGrid grid("DataFiles/rooms.csv");
+    int goalCell = -1;
+    for (int cell = 0; cell < grid.getRows() * grid.getCols() && goalCell == -1; cell++) {
+        if (grid.isOpen(cell / grid.getCols(), cell % grid.getCols())) goalCell = cell;
+    }
+
+    begin = Clock::now();
+    std::shared_ptr<const FlowField> field = grid.getFlowField(goalCell);
+    double gridSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    int reachable = 0;
+    for (int cell = 0; cell < field->size(); cell++) {
+        if (field->getDistance(cell) != std::numeric_limits<float>::infinity()) reachable++;
+    }
+    std::cout << "  rooms.csv grid field: " << gridSeconds * 1000 << " ms (" << reachable << " of "
+              << field->size() << " tiles reach the goal)" << std::endl;
+}
+
+// A grid level as a generic Graph with astar vs. Jump Point Search straight on the tiles.
+// The inside of the rooms.csv layout, without its outer wall, is tiled until the grid has about size tiles
+static void benchmarkJumpPoint(int size, int queryCount) {
+    OccupancyGrid rooms("DataFiles/rooms.csv");
+    int innerRows = rooms.getRows() - 2;
+    int innerCols = rooms.getCols() - 2;
+    int repeat = std::max(1, (int) std::sqrt((double) size / (innerRows * innerCols)));
+    int rows = innerRows * repeat;
+    int cols = innerCols * repeat;
+    std::cout << "[jps] " << rows << "x" << cols << " tiles (rooms.csv tiled " << repeat << "x" << repeat << "), " << queryCount << " queries" << std::endl;
+
+    OccupancyGrid grid(rows, cols, 1000, 1000);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            grid.setOpen(row, col, rooms.isOpen(1 + row % innerRows, 1 + col % innerCols));
+        }
+    }
+
+    // The same moves as an explicit graph: one vertex per tile, 8 neighbors, no corner cutting
+    Graph graph(true);
+    makeGridGraph(graph, grid, true);
+    graph.finalize();
+
+    // Only open tiles make sensible endpoints
+    std::vector<int> openCells;
+    for (int cell = 0; cell < rows * cols; cell++) {
+        if (grid.isOpen(cell / cols, cell % cols)) openCells.push_back(cell);
+    }
+    auto picks = makeQueries(openCells.size(), queryCount, 2);
+    std::vector<std::pair<int, int>> queries;
+    for (const auto& [start, goal] : picks) {
+        queries.push_back({openCells[start], openCells[goal]});
+    }
+
+    JumpPointSearch jps(grid);
+    SearchContext context;
+    int mismatches = 0;
+    for (const auto& [start, goal] : queries) {
+        Path graphPath, gridPath;
+        graph.findPath(start, goal, graphPath, context);
+        jps.findPath(start, goal, gridPath);
+        if (std::fabs(graphPath.distance - gridPath.distance) > 0.01f * (1 + graphPath.distance)) mismatches++;
+    }
+    std::cout << "  distance mismatches: " << mismatches << std::endl;
+
+    double astar = timeQueries("graph astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    double jump = timeQueries("jump point search", queries, [&](int s, int g) { return jps.astar(s, g); });
+
+    std::cout << "  speedup x" << jump / astar << std::endl;
+}
+
+// Inlined heuristic instantiations vs. the same estimates behind a std::function
+static void benchmarkHeuristic(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[heuristic] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    // A lambda is not one of the static heuristics, so it keeps the indirect call per vertex
+    graph.setHeuristic([](const sf::Vector2f& a, const sf::Vector2f& b) { return Graph::euclideanHeuristic(a, b); });
+    double indirect = timeQueries("std::function euclidean astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    graph.setHeuristic(Graph::EUCLIDEAN);
+    double inlined = timeQueries("inlined euclidean astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    std::cout << "  speedup x" << inlined / indirect << std::endl;
+
+    graph.setHeuristic(Graph::OCTILE);
+    timeQueries("inlined octile astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+
+    graph.buildLandmarks(8);
+    timeQueries("inlined alt astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+}
+
+// Every agent's path request served in one frame vs. spread over frames by a PathScheduler
+static void benchmarkTimeSlice(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[timeslice] " << side * side << " lattice vertices, " << queryCount << " requests in one frame" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    // Blocking: the frame the requests arrive in pays for all of them
+    SearchContext context;
+    std::vector<float> reference;
+    auto begin = Clock::now();
+    for (const auto& [start, goal] : queries) {
+        Path path;
+        graph.findPath(start, goal, path, context);
+        reference.push_back(path.distance);
+    }
+    double blocking = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    std::cout << "  blocking: one " << blocking << " ms frame" << std::endl;
+
+    for (long budget : {1000L, 4000L}) {
+        PathScheduler scheduler;
+        scheduler.reserve(graph.getVertexCount());
+        std::vector<std::shared_ptr<PathRequest>> requests;
+        for (const auto& [start, goal] : queries) {
+            requests.push_back(scheduler.request(graph, start, goal));
+        }
+
+        int frames = 0;
+        double longest = 0;
+        while (scheduler.size() > 0) {
+            auto frameBegin = Clock::now();
+            scheduler.update(budget);
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - frameBegin).count();
+            longest = std::max(longest, ms);
+            frames++;
+        }
+
+        int mismatches = 0;
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (std::fabs(requests[i]->getPath().distance - reference[i]) > 0.01f * (1 + reference[i])) mismatches++;
+        }
+        std::cout << "  " << budget << " us budget: " << frames << " frames, longest " << longest << " ms ("
+                  << mismatches << " distance mismatches)" << std::endl;
+    }
+}
+
+// Count queries whose bidirectional route length differs from the one-way search with the same heuristic
+static int countBidirectionalMismatches(const Graph& graph, const std::vector<std::pair<int, int>>& queries) {
+    SearchContext forward, backward;
+    int mismatches = 0;
+    for (const auto& [start, goal] : queries) {
+        Path oneWay, bothWays;
+        graph.findPath(start, goal, oneWay, forward);
+        graph.findPathBidirectional(start, goal, bothWays, forward, backward);
+        if (oneWay.vertices.empty() != bothWays.vertices.empty() ||
+            std::fabs(oneWay.distance - bothWays.distance) > 0.01f * (1 + oneWay.distance)) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void compareBidirectional(Graph& graph, const std::vector<std::pair<int, int>>& queries) {
+
+    // A zero heuristic turns both findPath variants into Dijkstra, which is exact on any weights
+    graph.setHeuristic([](const sf::Vector2f&, const sf::Vector2f&) { return 0.0f; });
+    std::cout << "  dijkstra: " << countBidirectionalMismatches(graph, queries) << " distance mismatches" << std::endl;
+    graph.setHeuristic(Graph::EUCLIDEAN);
+    std::cout << "  astar: " << countBidirectionalMismatches(graph, queries) << " distance mismatches" << std::endl;
+
+    double oneWay = timeQueries("dijkstra", queries, [&](int s, int g) { return graph.dijkstra(s, g); });
+    double bothWays = timeQueries("bidirectional dijkstra", queries, [&](int s, int g) { return graph.bidirectionalDijkstra(s, g); });
+    std::cout << "  speedup x" << bothWays / oneWay << std::endl;
+
+    oneWay = timeQueries("astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    bothWays = timeQueries("bidirectional astar", queries, [&](int s, int g) { return graph.bidirectionalAstar(s, g); });
+    std::cout << "  speedup x" << bothWays / oneWay << std::endl;
+}
+
+// Bidirectional searches vs. the one-way ones on the csv graph and a large random graph
+static void benchmarkBidirectional(int size, int queryCount) {
+    Graph csvGraph("DataFiles/vertices.csv", "DataFiles/edges.csv");
+    csvGraph.finalize();
+
+    // Every pair, since the csv graph is small
+    std::vector<std::pair<int, int>> allPairs;
+    for (int start = 0; start < csvGraph.getVertexCount(); start++) {
+        for (int goal = 0; goal < csvGraph.getVertexCount(); goal++) {
+            allPairs.push_back({start, goal});
+        }
+    }
+    std::cout << "[bidir] csv graph, " << csvGraph.getVertexCount() << " vertices, " << allPairs.size() << " queries" << std::endl;
+    compareBidirectional(csvGraph, allPairs);
+
+    std::cout << "[bidir] " << size << " random vertices, " << queryCount << " queries" << std::endl;
+    std::srand(1);
+    Graph graph(size);
+    graph.finalize();
+    compareBidirectional(graph, makeQueries(size, queryCount, 2));
+}
+
+// Count queries whose next-hop table distance differs from a fresh dijkstra
+static int countNextHopMismatches(Graph& graph, const std::vector<std::pair<int, int>>& queries) {
+    graph.refreshNextHopTable();
+    const NextHopTable& table = graph.getNextHopTable();
+
+    SearchContext context;
+    int mismatches = 0;
+    for (const auto& [start, goal] : queries) {
+        graph.dijkstra(start, goal, context);
+        float expected = context.getDistance(goal);
+        float stored = table.getDistance(start, goal);
+        if (expected != stored && std::fabs(expected - stored) > 0.01f * (1 + expected)) mismatches++;
+    }
+    return mismatches;
+}
+
+// All-pairs next-hop lookups vs. astar, and incremental repair vs. a full rebuild after edge removals
+static void benchmarkNextHop(int size, int queryCount) {
+    Graph csvGraph("DataFiles/vertices.csv", "DataFiles/edges.csv");
+    csvGraph.finalize();
+
+    std::vector<std::pair<int, int>> allPairs;
+    for (int start = 0; start < csvGraph.getVertexCount(); start++) {
+        for (int goal = 0; goal < csvGraph.getVertexCount(); goal++) {
+            allPairs.push_back({start, goal});
+        }
+    }
+    std::cout << "[nexthop] csv graph, " << csvGraph.getVertexCount() << " vertices, " << allPairs.size() << " queries" << std::endl;
+
+    double search = timeQueries("astar", allPairs, [&](int s, int g) { return csvGraph.astar(s, g); });
+    csvGraph.buildNextHopTable();
+    double lookup = timeQueries("table astar", allPairs, [&](int s, int g) { return csvGraph.astar(s, g); });
+    std::cout << "  speedup x" << lookup / search << " (" << countNextHopMismatches(csvGraph, allPairs) << " distance mismatches)" << std::endl;
+
+    int side = (int) std::sqrt((double) std::min(size, NextHopTable::MAX_VERTICES / 4));
+    std::cout << "[nexthop] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    for (int workers : {1, 0}) {
+        graph.setWorkerCount(workers);
+        auto begin = Clock::now();
+        graph.buildNextHopTable();
+        double buildTime = std::chrono::duration<double>(Clock::now() - begin).count();
+        std::cout << "  build with " << (workers == 0 ? "all" : "1") << " workers: " << buildTime << " s" << std::endl;
+    }
+
+    // The context overload always searches, so it times astar on the same graph
+    SearchContext context;
+    search = timeQueries("astar", queries, [&](int s, int g) { return graph.astar(s, g, context); });
+    lookup = timeQueries("table astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    std::cout << "  speedup x" << lookup / search << " (" << countNextHopMismatches(graph, queries) << " distance mismatches)" << std::endl;
+
+    // Knock out one corridor, then open one diagonal, repairing only the rows each change touched
+    int corner = (side / 2) * side + side / 2;
+    std::vector<std::pair<std::string, std::function<void()>>> changes = {
+        {"1 edge removal", [&]() {
+            graph.removeEdge(corner, corner + 1);
+        }},
+        {"1 diagonal edge addition", [&]() {
+            graph.addEdge(corner, corner + side + 1, Graph::euclideanHeuristic(graph.getPosition(corner), graph.getPosition(corner + side + 1)));
+        }},
+    };
+
+    for (const auto& [name, change] : changes) {
+        change();
+        int dirty = graph.getNextHopTable().getDirtyRowCount();
+
+        auto begin = Clock::now();
+        graph.refreshNextHopTable();
+        double refreshTime = std::chrono::duration<double>(Clock::now() - begin).count();
+        int mismatches = countNextHopMismatches(graph, queries);
+
+        begin = Clock::now();
+        graph.buildNextHopTable();
+        double rebuildTime = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        std::cout << "  " << name << " dirtied " << dirty << " of " << side * side << " rows: refresh " << refreshTime
+                  << " s vs rebuild " << rebuildTime << " s (" << mismatches << " distance mismatches)" << std::endl;
+    }
+}
+
+// Waypoints and length of rooms.csv routes before and after string pulling
+static void benchmarkSmoothing(int, int queryCount) {
+    OccupancyGrid grid("DataFiles/rooms.csv");
+    std::cout << "[smooth] rooms.csv " << grid.getRows() << "x" << grid.getCols() << " tiles, " << queryCount << " routes" << std::endl;
+
+    std::vector<int> openCells;
+    for (int cell = 0; cell < grid.getRows() * grid.getCols(); cell++) {
+        if (grid.isOpen(cell / grid.getCols(), cell % grid.getCols())) openCells.push_back(cell);
+    }
+    auto picks = makeQueries(openCells.size(), queryCount, 2);
+
+    PathSmoother smoother(grid);
+    for (bool diagonal : {false, true}) {
+        Graph graph(true);
+        makeGridGraph(graph, grid, diagonal);
+        graph.finalize();
+
+        SearchContext context;
+        std::vector<std::vector<sf::Vector2f>> routes;
+        for (const auto& [start, goal] : picks) {
+            Path path;
+            if (!graph.findPath(openCells[start], openCells[goal], path, context)) continue;
+
+            std::vector<sf::Vector2f> points;
+            for (int v : path.vertices) points.push_back(graph.getPosition(v));
+            routes.push_back(points);
+        }
+
+        long before = 0, after = 0, blocked = 0;
+        double lengthBefore = 0, lengthAfter = 0;
+        std::vector<sf::Vector2f> waypoints;
+
+        auto begin = Clock::now();
+        for (const auto& points : routes) {
+            smoother.smooth(points, waypoints);
+            before += points.size();
+            after += waypoints.size();
+            lengthBefore += PathSmoother::length(points);
+            lengthAfter += PathSmoother::length(waypoints);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        // Every shortcut must stay in the open
+        for (const auto& points : routes) {
+            smoother.smooth(points, waypoints);
+            for (size_t i = 1; i < waypoints.size(); i++) {
+                if (!grid.hasLineOfSight(waypoints[i - 1], waypoints[i])) blocked++;
+            }
+        }
+
+        std::cout << "  " << (diagonal ? 8 : 4) << "-neighbor routes: " << (double) before / routes.size() << " -> "
+                  << (double) after / routes.size() << " waypoints, length " << lengthBefore / routes.size() << " -> "
+                  << lengthAfter / routes.size() << ", " << seconds * 1e6 / routes.size() << " us per route ("
+                  << blocked << " blocked shortcuts)" << std::endl;
+    }
+}
+
+// The three SearchContext open lists on a random graph whose weights are rounded to integers
+static void benchmarkQueue(int size, int queryCount) {
+    std::cout << "[queue] " << size << " vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph(size);
+    graph.finalize();
+    auto queries = makeQueries(size, queryCount, 2);
+
+    std::vector<std::pair<std::string, SearchContext::QueueType>> queues = {
+        {"binary heap", SearchContext::BINARY_HEAP},
+        {"indexed heap", SearchContext::INDEXED_HEAP},
+        {"radix heap", SearchContext::RADIX_HEAP},
+    };
+
+    // Reference route lengths from the default queue
+    std::vector<float> reference;
+    SearchContext context;
+    for (const auto& [start, goal] : queries) {
+        Path path;
+        graph.findPath(start, goal, path, context);
+        reference.push_back(path.distance);
+    }
+
+    for (const auto& [name, type] : queues) {
+        graph.setQueueType(type);
+        context.setQueueType(type);
+
+        int mismatches = 0;
+        for (size_t i = 0; i < queries.size(); i++) {
+            Path path;
+            graph.findPath(queries[i].first, queries[i].second, path, context);
+            if (std::fabs(path.distance - reference[i]) > 0.01f * (1 + reference[i])) mismatches++;
+        }
+
+        // Equal-cost routes may be tied differently, so first-step checksums can differ between queues
+        std::cout << "  " << name << " (" << mismatches << " distance mismatches)" << std::endl;
+        timeQueries(name + " dijkstra", queries, [&](int s, int g) { return graph.dijkstra(s, g); });
+        timeQueries(name + " astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    }
+}
+
+// Contraction hierarchy queries vs. astar on a static detoured lattice
+static void benchmarkContraction(int size, int queryCount) {
+    int side = (int) std::sqrt((double) size);
+    std::cout << "[ch] " << side * side << " lattice vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    Graph graph;
+    makeLatticeGraph(graph, side, 1000, 4);
+    graph.finalize();
+    auto queries = makeQueries(side * side, queryCount, 2);
+
+    ContractionHierarchy hierarchy;
+    auto begin = Clock::now();
+    hierarchy.build(graph);
+    double buildTime = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    hierarchy.save("/tmp/benchmark_hierarchy.csv");
+    ContractionHierarchy loaded;
+    begin = Clock::now();
+    bool ok = loaded.load("/tmp/benchmark_hierarchy.csv", graph);
+    double loadTime = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  build " << buildTime << " s (" << hierarchy.getShortcutCount() << " shortcuts), reload "
+              << loadTime << " s" << (ok ? "" : " (failed)") << std::endl;
+
+    // The hierarchy must agree with a plain search on every distance
+    int mismatches = 0;
+    SearchContext context;
+    for (const auto& [start, goal] : queries) {
+        Path path;
+        graph.findPath(start, goal, path, context);
+        float distance = loaded.distance(start, goal);
+        if (std::fabs(distance - path.distance) > 0.01f * (1 + path.distance)) mismatches++;
+    }
+    std::cout << "  distance mismatches: " << mismatches << std::endl;
+
+    // Invalid ids right after a valid query must not reuse that query's search trees
+    int vertexCount = side * side;
+    std::vector<std::pair<int, int>> invalid = {{-1, 0}, {0, -1}, {-2, vertexCount - 1}, {vertexCount, 0}, {0, vertexCount + 5}};
+    int invalidAnswers = 0;
+    for (const auto& [start, goal] : invalid) {
+        std::vector<int> route;
+        loaded.distance(queries[0].first, queries[0].second);
+        if (loaded.firstStep(start, goal) != -1) invalidAnswers++;
+        loaded.distance(queries[0].first, queries[0].second);
+        if (loaded.findPath(start, goal, route) || !route.empty()) invalidAnswers++;
+    }
+    std::cout << "  answers for invalid ids: " << invalidAnswers << std::endl;
+
+    double astar = timeQueries("astar", queries, [&](int s, int g) { return graph.astar(s, g); });
+    double ch = timeQueries("ch first step", queries, [&](int s, int g) { return loaded.firstStep(s, g); });
+
+    std::cout << "  speedup x" << ch / astar << std::endl;
+}
+
+// Sum of the CSR arrays, so two graphs with the same edges in the same order hash the same
+static double edgeChecksum(const Graph& graph) {
+    double sum = 0;
+    for (int u = 0; u < graph.getVertexCount(); u++) {
+        graph.forEachNeighbor(u, [&](int v, float weight) {
+            sum += (u + 1) * 31.0 + v + weight;
+        });
+    }
+    return sum;
+}
+
+// Building large test graphs: the rand() generator vs. seeded k-nearest-neighbor graphs over the vertex grid
+static void benchmarkGenerate(int size, int queryCount) {
+    std::cout << "[generate] " << size << " vertices, " << queryCount << " queries" << std::endl;
+
+    std::srand(1);
+    auto begin = Clock::now();
+    Graph random(size);
+    random.finalize();
+    double randomSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::cout << "  generateRandomPositions: " << randomSeconds * 1000 << " ms (" << random.getEdgeCount() << " adjacency entries)" << std::endl;
+
+    for (int count : {size, size * 10}) {
+        Graph spatial;
+        begin = Clock::now();
+        spatial.generateSpatialGraph(count, 6, 7);
+        double spatialSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        std::cout << "  generateSpatialGraph " << count << ": " << spatialSeconds * 1000 << " ms ("
+                  << spatial.getEdgeCount() << " adjacency entries, " << spatialSeconds * 1e9 / count << " ns per vertex)" << std::endl;
+    }
+
+    Graph first, second;
+    first.generateSpatialGraph(size, 6, 7);
+    second.generateSpatialGraph(size, 6, 7);
+    bool same = first.getEdgeCount() == second.getEdgeCount() && edgeChecksum(first) == edgeChecksum(second);
+    std::cout << "  same seed, same graph: " << (same ? "yes" : "NO") << std::endl;
+
+    auto queries = makeQueries(size, queryCount, 2);
+    int reached = 0;
+    timeQueries("spatial astar", queries, [&](int s, int g) {
+        int step = first.astar(s, g);
+        if (step != -1 || s == g) reached++;
+        return step;
+    });
+    std::cout << "  reachable pairs: " << reached << "/" << queryCount << std::endl;
+}
+
+// Total route length over the queries whose ends are both live, through ids mapped by newIds when given
+static double routeLengthSum(Graph& graph, const std::vector<std::pair<int, int>>& queries, const std::vector<int>& newIds = {}) {
+    double total = 0;
+    for (auto [start, goal] : queries) {
+        if (!newIds.empty()) {
+            start = newIds[start];
+            goal = newIds[goal];
+        }
+        if (start == -1 || goal == -1 || graph.isRemoved(start) || graph.isRemoved(goal)) continue;
+
+        auto path = graph.getPath(start, goal);
+        if (path) total += path->distance;
+    }
+    return total;
+}
+
+// Destructible levels: removing vertices by scanning every adjacency list vs. through incoming edge lists
+static void benchmarkRemoval(int size, int queryCount) {
+    int removals = std::max(1, std::min(size / 10, 2000));
+    std::cout << "[removal] " << size << " vertices, " << removals << " removals, " << queryCount << " queries" << std::endl;
+
+    std::srand(3);
+    std::vector<int> victims;
+    for (int i = 0; i < removals; i++) {
+        victims.push_back(std::rand() % size);
+    }
+
+    auto timeRemovals = [&](const std::string& label, Graph& graph, int count) {
+        auto begin = Clock::now();
+        for (int i = 0; i < count; i++) {
+            graph.removeVertex(victims[i]);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        std::cout << "  " << label << ": " << seconds * 1e6 / count << " us per removal" << std::endl;
+        return seconds / count;
+    };
+
+    Graph scanned(true);
+    Graph tracked(true);
+    Graph undirected;
+    scanned.generateSpatialGraph(size, 6, 7);
+    tracked.generateSpatialGraph(size, 6, 7);
+    undirected.generateSpatialGraph(size, 6, 7);
+    tracked.setMutable(true);
+
+    // The scan is O(E) per removal, so only time a sample of it and finish the rest untimed
+    int sample = std::min(removals, 100);
+    double scanSeconds = timeRemovals("directed, full scan", scanned, sample);
+    for (int i = sample; i < removals; i++) {
+        scanned.removeVertex(victims[i]);
+    }
+
+    // The first removal builds the incoming lists, so it is timed with the rest
+    double trackedSeconds = timeRemovals("directed, incoming lists", tracked, removals);
+    timeRemovals("undirected", undirected, removals);
+    std::cout << "  speedup x" << scanSeconds / trackedSeconds << std::endl;
+
+    auto queries = makeQueries(size, queryCount, 2);
+    bool sameEdges = scanned.getEdgeCount() == tracked.getEdgeCount();
+    bool sameRoutes = routeLengthSum(scanned, queries) == routeLengthSum(tracked, queries);
+    std::cout << "  scan and incoming lists agree: " << (sameEdges && sameRoutes ? "yes" : "NO") << std::endl;
+
+    // A binary save has no tombstones, so it must not bring the removed vertices back
+    int live = 0;
+    for (int v = 0; v < scanned.getVertexCount(); v++) {
+        if (!scanned.isRemoved(v)) live++;
+    }
+    sf::Vector2f gone = scanned.getVertex(victims[0]).position;
+    Graph reloaded;
+    bool roundTrip = scanned.saveBinary("/tmp/benchmark_removal.bin") && reloaded.loadBinary("/tmp/benchmark_removal.bin");
+    bool dropped = roundTrip && reloaded.getVertexCount() == live
+                   && reloaded.getClosestVertex((int) gone.x, (int) gone.y).position != gone;
+    std::cout << "  removed vertices dropped by saveBinary: " << (dropped ? "yes" : "NO") << std::endl;
+
+    double before = routeLengthSum(undirected, queries);
+    long edges = undirected.getEdgeCount();
+    auto begin = Clock::now();
+    std::vector<int> newIds = undirected.compact();
+    double compactSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    bool preserved = undirected.getEdgeCount() == edges && routeLengthSum(undirected, queries, newIds) == before;
+    std::cout << "  compact: " << compactSeconds * 1000 << " ms, " << undirected.getVertexCount()
+              << " vertices left, routes preserved: " << (preserved ? "yes" : "NO") << std::endl;
+}
+
+// Moving every agent once per tick: heap-allocated Kinematics reached through pointers, as each
+// agent integrated its own, vs. one pass over the KinematicStore arrays
+static void benchmarkKinematics(int size, int queryCount) {
+    int ticks = std::max(queryCount, 1);
+    std::cout << "[kinematics] " << size << " agents, " << ticks << " ticks" << std::endl;
+
+    std::mt19937 engine(5);
+    std::uniform_real_distribution<float> coordinate(0, 1000);
+    std::uniform_real_distribution<float> unit(-1, 1);
+
+    KinematicStore store;
+    std::vector<std::unique_ptr<Kinematic>> owned;
+    std::vector<SteeringOutput> steering(size);
+    for (int i = 0; i < size; i++) {
+        Kinematic kinematic;
+        kinematic.id = i;
+        kinematic.position = sf::Vector2f(coordinate(engine), coordinate(engine) * 0.8f);
+        kinematic.velocity = sf::Vector2f(unit(engine) * 20, unit(engine) * 20);
+        kinematic.maxSpeed = 20;
+        kinematic.maxRotation = M_PI / 4;
+        store.add(kinematic, KinematicStore::ENTITY);
+        owned.push_back(std::make_unique<Kinematic>(kinematic));
+
+        steering[i].linear = sf::Vector2f(unit(engine) * 15, unit(engine) * 15);
+        steering[i].angular = unit(engine);
+    }
+
+    // Agents are spawned and removed over a game, so their heap blocks end up scattered
+    std::vector<Kinematic*> agents;
+    for (auto& kinematic : owned) agents.push_back(kinematic.get());
+    std::shuffle(agents.begin(), agents.end(), engine);
+
+    const float deltaTime = 1.0f / 60;
+    auto begin = Clock::now();
+    for (int tick = 0; tick < ticks; tick++) {
+        for (Kinematic* kinematic : agents) {
+            const SteeringOutput& output = steering[kinematic->id];
+            kinematic->position += kinematic->velocity * deltaTime;
+            kinematic->orientation = VectorUtils::mapToPiRange(kinematic->orientation + kinematic->rotation * deltaTime);
+            kinematic->velocity += output.linear * deltaTime;
+            kinematic->rotation += output.angular * deltaTime;
+            if (VectorUtils::vector2Length(kinematic->velocity) > kinematic->maxSpeed) {
+                kinematic->velocity = VectorUtils::normalize(kinematic->velocity) * kinematic->maxSpeed;
+            }
+            if (std::fabs(kinematic->rotation) > kinematic->maxRotation) {
+                kinematic->rotation = std::copysign(1.0f, kinematic->rotation) * kinematic->maxRotation;
+            }
+            if (kinematic->position.x < -5) kinematic->position.x = 1000;
+            else if (kinematic->position.x > 1005) kinematic->position.x = 0;
+            if (kinematic->position.y < -5) kinematic->position.y = 800;
+            else if (kinematic->position.y > 805) kinematic->position.y = 0;
+        }
+    }
+    double pointerSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    // The reference scalar pass and the SIMD pass, from the same starting state
+    KinematicStore simd = store;
+    store.setIntegrationMode(KinematicStore::SCALAR);
+    simd.setIntegrationMode(KinematicStore::SIMD);
+
+    auto timeStore = [&](KinematicStore& kinematics) {
+        auto start = Clock::now();
+        for (int tick = 0; tick < ticks; tick++) {
+            for (int i = 0; i < size; i++) {
+                kinematics.setSteering(i, steering[i]);
+            }
+            kinematics.integrate(deltaTime);
+            kinematics.wrap(1000, 800, 5);
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    double scalarSeconds = timeStore(store);
+    double simdSeconds = timeStore(simd);
+
+    // Both started from the same state and applied the same steering
+    double drift = 0;
+    for (int i = 0; i < size; i++) {
+        drift = std::max(drift, (double) VectorUtils::vector2Length(store.getPosition(i) - owned[i]->position));
+    }
+
+    auto sameBits = [&](const float* a, const float* b) {
+        return std::memcmp(a, b, size * sizeof(float)) == 0;
+    };
+    bool identical = sameBits(store.getPositionX(), simd.getPositionX()) && sameBits(store.getPositionY(), simd.getPositionY())
+                     && sameBits(store.getVelocityX(), simd.getVelocityX()) && sameBits(store.getVelocityY(), simd.getVelocityY())
+                     && sameBits(store.getOrientations(), simd.getOrientations()) && sameBits(store.getRotations(), simd.getRotations());
+
+    std::cout << "  pointers: " << size * (double) ticks / pointerSeconds / 1e6 << " M agent updates/s" << std::endl;
+    std::cout << "  store, scalar: " << size * (double) ticks / scalarSeconds / 1e6 << " M agent updates/s" << std::endl;
+    std::cout << "  store, simd: " << size * (double) ticks / simdSeconds / 1e6 << " M agent updates/s" << std::endl;
+    std::cout << "  speedup x" << pointerSeconds / scalarSeconds << " scalar, x" << pointerSeconds / simdSeconds
+              << " simd; largest position difference from pointers " << drift << std::endl;
+    std::cout << "  simd bit-identical to scalar: " << (identical ? "yes" : "NO") << std::endl;
+}
+
+// Boids spread at the same density at every population, so each sees about as many neighbors
+static void fillFlock(KinematicStore& store, int count, float side, std::mt19937& engine) {
+    std::uniform_real_distribution<float> coordinate(0, side);
+    std::uniform_real_distribution<float> unit(-1, 1);
+    for (int i = 0; i < count; i++) {
+        Kinematic kinematic;
+        kinematic.id = i;
+        kinematic.position = sf::Vector2f(coordinate(engine), coordinate(engine));
+        kinematic.velocity = sf::Vector2f(unit(engine) * 8, unit(engine) * 8);
+        kinematic.maxSpeed = 8;
+        kinematic.maxRotation = M_PI / 4;
+        store.add(kinematic, KinematicStore::ENTITY);
+    }
+}
+
+static void benchmarkFlocking(int size, int queryCount) {
+    int ticks = std::max(queryCount / 10, 1);
+    std::cout << "[flocking] 30 to " << size << " boids, " << ticks << " ticks each" << std::endl;
+
+    std::vector<int> populations;
+    for (int count = 30; count < size; count *= 10) populations.push_back(count);
+    populations.push_back(size);
+
+    for (int count : populations) {
+        std::mt19937 engine(9);
+        KinematicStore store;
+        float side = std::sqrt((float) count) * 40;
+        fillFlock(store, count, side, engine);
+
+        // The parameters the game flocks with
+        Flocking flocking(.3, 100, 20, .01, .7, .5, 12);
+        SpatialHash grid(100);
+
+        double rebuildSeconds = 0, gridSeconds = 0;
+        for (int tick = 0; tick < ticks; tick++) {
+            auto begin = Clock::now();
+            grid.rebuild(store);
+            auto built = Clock::now();
+            for (int i = 0; i < count; i++) {
+                store.setSteering(i, flocking.steer(store.get(i), store, &grid));
+            }
+            auto steered = Clock::now();
+            store.integrate(0.1f);
+
+            rebuildSeconds += std::chrono::duration<double>(built - begin).count();
+            gridSeconds += std::chrono::duration<double>(steered - built).count();
+        }
+
+        // The full scan is quadratic, so time it on a sample and scale up. The grid must give
+        // the same steering to the bit, since it sums the same neighbors in the same order
+        grid.rebuild(store);
+        int sample = std::min(count, 1000);
+        int mismatches = 0;
+        auto begin = Clock::now();
+        for (int i = 0; i < sample; i++) {
+            SteeringOutput scanned = flocking.steer(store.get(i), store, nullptr);
+            SteeringOutput local = flocking.steer(store.get(i), store, &grid);
+            if (scanned.linear != local.linear) mismatches++;
+        }
+        double scanSeconds = std::chrono::duration<double>(Clock::now() - begin).count() * count / sample;
+
+        // k-nearest against sorting every distance
+        int knnMismatches = 0;
+        std::vector<int> nearest;
+        for (int i = 0; i < std::min(count, 200); i++) {
+            sf::Vector2f center = store.getPosition(i);
+            grid.kNearest(center, 8, KinematicStore::ENTITY, nearest, i);
+
+            std::vector<std::pair<float, int>> all;
+            for (int j = 0; j < count; j++) {
+                if (j == i) continue;
+                sf::Vector2f d = store.getPosition(j) - center;
+                all.push_back({d.x * d.x + d.y * d.y, j});
+            }
+            std::sort(all.begin(), all.end());
+            for (int j = 0; j < (int) nearest.size(); j++) {
+                if (nearest[j] != all[j].second) {
+                    knnMismatches++;
+                    break;
+                }
+            }
+            if ((int) nearest.size() != std::min(count - 1, 8)) knnMismatches++;
+        }
+
+        double gridTick = (rebuildSeconds + gridSeconds) / ticks;
+        std::cout << "  " << count << " boids: scan " << scanSeconds * 1e3 << " ms/tick, grid " << gridTick * 1e3
+                  << " ms/tick (rebuild " << rebuildSeconds / ticks * 1e3 << " ms), speedup x" << scanSeconds / gridTick
+                  << ", " << gridSeconds / ticks / count * 1e9 << " ns per boid" << std::endl;
+        std::cout << "    steering mismatches " << mismatches << "/" << sample << ", k-nearest mismatches " << knnMismatches << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string suite = argc > 1 ? argv[1] : "all";
+    int size = argc > 2 ? std::atoi(argv[2]) : 50000;
+    int queries = argc > 3 ? std::atoi(argv[3]) : 100;
+
+    std::map<std::string, std::function<void(int, int)>> suites = {
+        {"alt", benchmarkLandmarks},
+        {"batch", benchmarkBatch},
+        {"bidir", benchmarkBidirectional},
+        {"binary", benchmarkBinary},
+        {"ch", benchmarkContraction},
+        {"closest", benchmarkClosest},
+        {"csr", benchmarkCsr},
+        {"dstar", benchmarkDStarLite},
+        {"flocking", benchmarkFlocking},
+        {"flow", benchmarkFlowField},
+        {"generate", benchmarkGenerate},
+        {"heuristic", benchmarkHeuristic},
+        {"hpa", benchmarkHierarchical},
+        {"jps", benchmarkJumpPoint},
+        {"kinematics", benchmarkKinematics},
+        {"nexthop", benchmarkNextHop},
+        {"pathcache", benchmarkPathCache},
+        {"queue", benchmarkQueue},
+        {"removal", benchmarkRemoval},
+        {"smooth", benchmarkSmoothing},
+        {"timeslice", benchmarkTimeSlice},
+    };
+
+    if (suite == "all") {
+        for (auto& [name, run] : suites) {
+            run(size, queries);
+        }
+        return 0;
+    }
+
+    auto it = suites.find(suite);
+    if (it == suites.end()) {
+        std::cerr << "Unknown suite: " << suite << std::endl;
+        return 1;
+    }
+    it->second(size, queries);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include <cstring>
+#include <iostream>
+#include "Graph.h"
+
+// Converts a vertices/edges csv pair into the binary graph file read by Graph::loadBinary.
+// Run as ./graphconvert vertices.csv edges.csv out.bin [directed]
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " vertices.csv edges.csv out.bin [directed]" << std::endl;
+        return 1;
+    }
+
+    bool directed = argc > 4 && std::strcmp(argv[4], "directed") == 0;
+
+    Graph graph(argv[1], argv[2], directed);
+    if (!graph.saveBinary(argv[3])) {
+        return 1;
+    }
+
+    std::cout << "Wrote " << graph.getVertexCount() << " vertices and " << graph.getEdgeCount()
+              << " adjacency entries to " << argv[3] << std::endl;
+    return 0;
+}
@@ -1,9 +1,25 @@
 #include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 #include "Game.h"
 
-int main()
+int main(int argc, char* argv[])
 {
 
+    // ./main --headless [ticks] [seed] steps the world without a window and reports the tick rate.
+    // With a seed, every run replays the same way
+    if (argc > 1 && std::string(argv[1]) == "--headless") {
+        long ticks = argc > 2 ? std::atol(argv[2]) : 10000;
+        if (argc > 3) VectorUtils::seedRandom(std::atoi(argv[3]));
+
+        Game::setHeadless(true);
+        Game& game = Game::getInstance();
+        double ticksPerSecond = game.runHeadless(ticks, game.getFixedTimestep());
+        std::cout << ticks << " ticks, " << ticksPerSecond << " ticks/s" << std::endl;
+        return 0;
+    }
+
     Game& game = Game::getInstance();
     game.run();
     return 0;